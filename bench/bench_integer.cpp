@@ -0,0 +1,629 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "integer.h"
+#include "montgomery.h"
+#include "modint.h"
+#include "allocator.h"
+#include "integer_expr.h"
+#include "prime.h"
+#include "bigint.h"
+
+namespace {
+    std::mt19937_64 rand_engine(19519);
+
+    template<class Int>
+    Int random_integer() {
+        Int res;
+        for (std::size_t i = 0; i < Int::array_size; ++i) {
+            res._data[i] = static_cast<typename Int::word_type>(rand_engine());
+        }
+        res._normalize();
+        return res;
+    }
+
+    template<class Func>
+    double ns_per_op(std::size_t iters, Func func) {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iters; ++i) {
+            func();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / iters;
+    }
+
+    void print_row(std::size_t n, double before, double after) {
+        std::cout << std::setw(8) << n
+                  << std::setw(14) << std::fixed << std::setprecision(1) << before
+                  << std::setw(14) << after
+                  << std::setw(10) << std::setprecision(1) << before / after << "x\n";
+    }
+
+    template<std::size_t N>
+    void bench_add() {
+        using type = exlib::nints<N>;
+        auto a = random_integer<type>();
+        auto b = random_integer<type>();
+        const std::size_t iters = (1 << 22) / N;
+
+        double bitwise = ns_per_op(iters, [&] {
+            a.template _bitwise_add_assign<N>(
+            [&a](std::size_t i) { return a._at(i); },
+            [&b](std::size_t i) { return b[i]; });
+        });
+        double limb = ns_per_op(iters, [&] { a += b; });
+        print_row(N, bitwise, limb);
+    }
+
+    template<std::size_t N>
+    void bench_sub() {
+        using type = exlib::nints<N>;
+        auto a = random_integer<type>();
+        auto b = random_integer<type>();
+        const std::size_t iters = (1 << 22) / N;
+
+        double bitwise = ns_per_op(iters, [&] {
+            a.template _bitwise_sub_assign<N>(
+            [&a](std::size_t i) { return a._at(i); },
+            [&b](std::size_t i) { return b[i]; });
+        });
+        double limb = ns_per_op(iters, [&] { a -= b; });
+        print_row(N, bitwise, limb);
+    }
+
+    double mul_n_ns(std::size_t n, exlib::details::mul_thresholds th);
+
+    // operator* against the full schoolbook product of the same limbs, small widths gain
+    // from keeping only N bits and large ones from the subquadratic tiers
+    template<std::size_t N>
+    void bench_mul() {
+        using type = exlib::nints<N>;
+        auto a = random_integer<type>();
+        auto b = random_integer<type>();
+        const std::size_t iters = std::max<std::size_t>((1 << 26) / (N * N / 64), 16);
+
+        type sink = 0;
+        double limb = ns_per_op(iters, [&] { sink += a * b; });
+        double basecase = mul_n_ns(type::array_size, {type::array_size + 1, std::numeric_limits<std::size_t>::max()});
+        print_row(N, basecase, limb);
+    }
+
+    template<std::size_t N>
+    void bench_div() {
+        using type = exlib::unints<N>;
+        auto a = random_integer<type>();
+        auto b = random_integer<type>() >> (N / 2);
+        type w = static_cast<unsigned int>(rand_engine() | 1);
+        const std::size_t iters = std::max<std::size_t>((1 << 24) / (N * N / 64), 16);
+
+        type sink = 0;
+        double long_div = ns_per_op(iters, [&] { sink += a / b; });
+        double word_div = ns_per_op(iters, [&] { sink += a / w; });
+        std::cout << std::setw(8) << N
+                  << std::setw(14) << std::fixed << std::setprecision(1) << long_div
+                  << std::setw(14) << word_div << "\n";
+    }
+
+    template<std::size_t N>
+    void bench_str() {
+        using type = exlib::nints<N>;
+        auto a = random_integer<type>();
+        const std::size_t iters = std::max<std::size_t>((1 << 22) / (N * N / 64), 4);
+
+        std::size_t sink = 0;
+        double ns = ns_per_op(iters, [&] { sink += a.str().size(); });
+        std::cout << std::setw(8) << N
+                  << std::setw(14) << std::fixed << std::setprecision(1) << ns << "\n";
+    }
+
+    template<std::size_t N>
+    void bench_rd_string() {
+        using type = exlib::nints<N>;
+        const std::string s = random_integer<type>().str();
+        const std::size_t iters = std::max<std::size_t>((1 << 22) / (N * N / 64), 4);
+
+        type a;
+        double ns = ns_per_op(iters, [&] { a.rd_string(s); });
+        std::cout << std::setw(8) << N
+                  << std::setw(14) << std::fixed << std::setprecision(1) << ns << "\n";
+    }
+
+    // 2N bit acc += a * b for N bit operands, upcast operands against fma
+    template<std::size_t N>
+    void bench_fma() {
+        using type = exlib::nints<N>;
+        using wide = exlib::nints<2 * N>;
+        const type a = random_integer<type>(), b = random_integer<type>();
+        const std::size_t iters = std::max<std::size_t>((1 << 22) / (N * N / 64), 16);
+
+        wide acc = 0;
+        double upcast = ns_per_op(iters, [&] { acc += wide(a) * wide(b); });
+        double fused = ns_per_op(iters, [&] { exlib::fma(acc, a, b); });
+        print_row(N, upcast, fused);
+    }
+
+    // N bit modular exponentiation, square and multiply with a % per step against montgomery
+    template<std::size_t N>
+    void bench_powmod() {
+        using type = exlib::integer<N, unsigned long long, void, false>;
+        using wide = exlib::integer<2 * N, unsigned long long, void, false>;
+        const type m = random_integer<type>() | 1, a = random_integer<type>() % m, e = random_integer<type>();
+        const std::size_t iters = std::max<std::size_t>((1 << 20) / (N * N / 64), 2);
+
+        type r;
+        double plain = ns_per_op(iters, [&] {
+            wide res = 1, base = a, wm = m;
+            for (std::size_t i = 0; i < N; ++i) {
+                if (e[i]) res = res * base % wm;
+                base = base * base % wm;
+            }
+            r = res;
+        });
+        double mont = ns_per_op(iters, [&] { r = exlib::montgomery_context<type>(m).powmod(a, e); });
+        print_row(N, plain, mont);
+    }
+
+    // N bit modular product, double width product and % against a barrett modint
+    template<std::size_t N>
+    void bench_modint() {
+        using type = exlib::integer<N, unsigned long long, void, false>;
+        using wide = exlib::integer<2 * N, unsigned long long, void, false>;
+        using mint = exlib::modint<type>;
+        const type m = random_integer<type>() & ~type(1);
+        mint::set_mod(m);
+        const type a = random_integer<type>() % m, b = random_integer<type>() % m;
+        const std::size_t iters = std::max<std::size_t>((1 << 24) / (N * N / 64), 16);
+
+        wide x = a;
+        double plain = ns_per_op(iters, [&] { x = x * wide(b) % wide(m); });
+        mint y(a), z(b);
+        double barrett = ns_per_op(iters, [&] { y *= z; });
+        print_row(N, plain, barrett);
+    }
+
+    // N bit sums through heap storage, std::allocator against Alloc
+    template<std::size_t N, template<class> class Alloc>
+    void bench_alloc() {
+        using word = unsigned int;
+        using heap = exlib::integer<N, word, std::allocator<word>, true>;
+        using type = exlib::integer<N, word, Alloc<word>, true>;
+        const heap a = random_integer<heap>(), b = random_integer<heap>();
+        const type c = a, d = b;
+        const std::size_t iters = std::max<std::size_t>((1 << 26) / N, 16);
+
+        heap x = 0;
+        double plain = ns_per_op(iters, [&] { x = (a + b) >> 1; });
+        type y = 0;
+        double pooled = ns_per_op(iters, [&] {
+            exlib::arena_scope scope;
+            y = (c + d) >> 1;
+        });
+        print_row(N, plain, pooled);
+    }
+
+    // r = a * b + c - d, eager operators against a lazy expression
+    template<std::size_t N>
+    void bench_expr() {
+        using type = exlib::nints<N>;
+        const type a = random_integer<type>(), b = random_integer<type>(), c = random_integer<type>(), d = random_integer<type>();
+        const std::size_t iters = std::max<std::size_t>((1 << 24) / (N * N / 64), 16);
+
+        type r;
+        double eager = ns_per_op(iters, [&] { r = a * b + c - d; r._data[0] ^= 1; });
+        double lazy = ns_per_op(iters, [&] { r = exlib::lazy(a) * b + c - d; r._data[0] ^= 1; });
+        print_row(N, eager, lazy);
+    }
+
+    // floor(sqrt(x)) for an N bit x, bisection over operator* against isqrt
+    template<std::size_t N>
+    void bench_isqrt() {
+        using type = exlib::nints<N>;
+        using wide = exlib::nints<2 * N>;
+        const type x = (random_integer<type>() >> 1).abs();
+        const std::size_t iters = std::max<std::size_t>((1 << 22) / (N * N / 64), 4);
+
+        type r;
+        double bisection = ns_per_op(std::max<std::size_t>(iters / 64, 1), [&] {
+            type lo = 0, hi = type(1) << (N / 2);
+            while (lo < hi) {
+                type mid = (lo + hi + 1) >> 1;
+                if (wide(mid) * wide(mid) <= wide(x)) lo = mid;
+                else hi = mid - 1;
+            }
+            r = lo;
+        });
+        double newton = ns_per_op(iters, [&] { r = exlib::isqrt(x); });
+        print_row(N, bisection, newton);
+    }
+
+    // gcd of two N bit values, euclid on divmod against exlib::gcd
+    template<std::size_t N>
+    void bench_gcd() {
+        using type = exlib::nints<N>;
+        const type a = random_integer<type>(), b = random_integer<type>();
+        const std::size_t iters = std::max<std::size_t>((1 << 22) / (N * N / 64), 4);
+
+        type g;
+        double euclid = ns_per_op(std::max<std::size_t>(iters / 16, 1), [&] {
+            type x = a, y = b;
+            while (y != 0) {
+                x = std::exchange(y, exlib::divmod(x, y).second);
+            }
+            g = x;
+        });
+        double lehmer = ns_per_op(iters, [&] { g = exlib::gcd(a, b); });
+        print_row(N, euclid, lehmer);
+    }
+
+    // the leading one of an N bit value with its top half clear, found a bit at a time
+    // from the top as nfloats did against bit_width
+    template<std::size_t N>
+    void bench_bit_width() {
+        using type = exlib::unints<N>;
+        type x = random_integer<type>() >> (N / 2);
+        const std::size_t iters = std::max<std::size_t>((1 << 22) / N, 4);
+
+        // the low word is stirred so that the scan is not hoisted out of the loop
+        std::size_t sink = 0;
+        double bitwise = ns_per_op(iters, [&] {
+            for (std::size_t j = N - 1; ~j; j--) {
+                if (x[j]) {
+                    sink += j;
+                    break;
+                }
+            }
+            x._data[0] ^= static_cast<unsigned int>(sink);
+        });
+        double scan = ns_per_op(iters, [&] {
+            sink += x.bit_width();
+            x._data[0] ^= static_cast<unsigned int>(sink);
+        });
+        print_row(N, bitwise, scan);
+    }
+
+    // the next prime after an N bit value, odd candidates one at a time through
+    // is_probable_prime against the sieved window of next_prime
+    template<std::size_t N>
+    void bench_next_prime() {
+        using type = exlib::unints<N + 64>;
+        type x = random_integer<exlib::unints<N>>();
+        const std::size_t iters = std::max<std::size_t>((1 << 14) / N, 2);
+
+        type p;
+        double single = ns_per_op(iters, [&] {
+            p = x + (x[0] ? 2 : 1);
+            while (!exlib::is_probable_prime(p)) {
+                p += 2;
+            }
+            x += 2;
+        });
+        double sieved = ns_per_op(iters, [&] {
+            p = exlib::next_prime(x);
+            x += 2;
+        });
+        print_row(N, single, sieved);
+    }
+
+    // a multiply-add on B bit values held in unints<8192> sized for the worst case
+    // against bigint, which only runs over the limbs the values have
+    template<std::size_t B>
+    void bench_bigint() {
+        using type = exlib::unints<8192, unsigned long long>;
+        const type a = random_integer<exlib::unints<B, unsigned long long>>(), b = random_integer<exlib::unints<B, unsigned long long>>();
+        const exlib::bigint x = a, y = b;
+        const std::size_t iters = std::max<std::size_t>((1 << 16) / B, 4);
+
+        type r;
+        exlib::bigint s;
+        double fixed = ns_per_op(iters, [&] { r = a * b + a; });
+        double sized = ns_per_op(iters * 16, [&] { s = x * y + x; });
+        print_row(B, fixed, sized);
+    }
+
+    // big endian bytes shifted out one at a time against the limb copy
+    template<std::size_t N>
+    void bench_bytes() {
+        using type = exlib::unints<N, unsigned long long>;
+        const type a = random_integer<type>();
+        std::vector<std::byte> out(N / 8);
+        const std::size_t iters = std::max<std::size_t>((1 << 18) / N, 4);
+
+        double shifted = ns_per_op(iters, [&] {
+            for (std::size_t k = 0; k < out.size(); ++k) {
+                out[out.size() - 1 - k] = static_cast<std::byte>(static_cast<std::uint8_t>(a >> (8 * k)));
+            }
+        });
+        double copied = ns_per_op(iters * 64, [&] { a.to_bytes(out, std::endian::big); });
+        print_row(N, shifted, copied);
+    }
+
+    // one level of the faster algorithm against the one below it at n limbs,
+    // the threshold should sit where the ratio drops under 1
+    double mul_n_ns(std::size_t n, exlib::details::mul_thresholds th) {
+        using word = unsigned int;
+        std::vector<word> a(n), b(n), r(2 * n);
+        std::vector<word> scratch(exlib::details::limb_mul_n_scratch_size(n, th) + 1);
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = static_cast<word>(rand_engine());
+            b[i] = static_cast<word>(rand_engine());
+        }
+        const std::size_t iters = std::max<std::size_t>((1 << 24) / (n * n), 8);
+        return ns_per_op(iters, [&] {
+            exlib::details::limb_mul_n(r.data(), a.data(), b.data(), n, scratch.data(), th);
+            a[0] ^= r[n];
+        });
+    }
+
+    void tune_mul_thresholds() {
+        constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+        constexpr auto current = exlib::details::default_mul_thresholds;
+
+        std::cout << "\nkaratsuba threshold (current " << current.karatsuba << " limbs)\n"
+                  << std::setw(8) << "limbs"
+                  << std::setw(14) << "basecase ns"
+                  << std::setw(14) << "karatsuba ns"
+                  << std::setw(11) << "speedup\n";
+        for (std::size_t n : {8, 12, 16, 24, 32, 48, 64}) {
+            double base = mul_n_ns(n, {n + 1, inf});
+            double kara = mul_n_ns(n, {n, inf});
+            print_row(n, base, kara);
+        }
+
+        std::cout << "\ntoom-3 threshold (current " << current.toom3 << " limbs)\n"
+                  << std::setw(8) << "limbs"
+                  << std::setw(14) << "karatsuba ns"
+                  << std::setw(14) << "toom-3 ns"
+                  << std::setw(11) << "speedup\n";
+        for (std::size_t n : {128, 192, 256, 320, 384, 512, 768}) {
+            double kara = mul_n_ns(n, {current.karatsuba, n + 1});
+            double toom = mul_n_ns(n, {current.karatsuba, n});
+            print_row(n, kara, toom);
+        }
+
+        std::cout << "\nntt threshold (current " << current.ntt << " limbs)\n"
+                  << std::setw(8) << "limbs"
+                  << std::setw(14) << "toom-3 ns"
+                  << std::setw(14) << "ntt ns"
+                  << std::setw(11) << "speedup\n";
+        for (std::size_t n : {1024, 2048, 3072, 4096, 6144, 8192, 16384}) {
+            double toom = mul_n_ns(n, {current.karatsuba, current.toom3, current.full_product, n + 1});
+            double ntt = mul_n_ns(n, {current.karatsuba, current.toom3, current.full_product, n});
+            print_row(n, toom, ntt);
+        }
+
+        std::cout << "\nfull product threshold (current " << current.full_product << " limbs)\n"
+                  << std::setw(8) << "limbs"
+                  << std::setw(14) << "low ns"
+                  << std::setw(14) << "full ns"
+                  << std::setw(11) << "speedup\n";
+        for (std::size_t n : {32, 48, 64, 96, 128, 192}) {
+            using word = unsigned int;
+            std::vector<word> a(n, static_cast<word>(rand_engine())), b(n, static_cast<word>(rand_engine())), r(2 * n);
+            std::vector<word> scratch(exlib::details::limb_mul_scratch_size(n, n) + 1);
+            const std::size_t iters = std::max<std::size_t>((1 << 24) / (n * n), 8);
+            double low = ns_per_op(iters, [&] {
+                exlib::details::limb_mul_low(r.data(), n, a.data(), n, b.data(), n);
+                a[0] ^= r[1];
+            });
+            double full = ns_per_op(iters, [&] {
+                exlib::details::limb_mul(r.data(), a.data(), n, b.data(), n, scratch.data());
+                a[0] ^= r[1];
+            });
+            print_row(n, low, full);
+        }
+    }
+
+    // 2n / n limb division, basecase against barrett
+    double div_n_ns(std::size_t n, exlib::details::div_thresholds th) {
+        using word = unsigned int;
+        std::vector<word> a(2 * n), d(n), q(n + 1), r(n);
+        std::vector<word> scratch(exlib::details::limb_div_qr_scratch_size(2 * n, n));
+        for (auto& x : a) x = static_cast<word>(rand_engine());
+        for (auto& x : d) x = static_cast<word>(rand_engine());
+        d[n - 1] |= 1;
+        const std::size_t iters = std::max<std::size_t>((1 << 24) / (n * n), 8);
+        return ns_per_op(iters, [&] {
+            exlib::details::limb_div_qr(q.data(), r.data(), a.data(), 2 * n, d.data(), n, scratch.data(), th);
+            a[0] ^= q[0];
+        });
+    }
+
+    void tune_div_thresholds() {
+        constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+        std::cout << "\nbarrett threshold (current " << exlib::details::default_div_thresholds.barrett << " limbs)\n"
+                  << std::setw(8) << "limbs"
+                  << std::setw(14) << "basecase ns"
+                  << std::setw(14) << "barrett ns"
+                  << std::setw(11) << "speedup\n";
+        for (std::size_t n : {256, 512, 1024, 1536, 2048, 4096}) {
+            double base = div_n_ns(n, {inf});
+            double barrett = div_n_ns(n, {n});
+            print_row(n, base, barrett);
+        }
+    }
+
+    void print_header(const char* title) {
+        std::cout << "\n" << title << "\n"
+                  << std::setw(8) << "N"
+                  << std::setw(14) << "bitwise ns"
+                  << std::setw(14) << "limb ns"
+                  << std::setw(11) << "speedup\n";
+    }
+}
+
+int main() {
+    print_header("operator+=");
+    bench_add<64>();
+    bench_add<256>();
+    bench_add<1024>();
+    bench_add<4096>();
+
+    print_header("operator-=");
+    bench_sub<64>();
+    bench_sub<256>();
+    bench_sub<1024>();
+    bench_sub<4096>();
+
+    std::cout << "\noperator*\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "basecase ns"
+              << std::setw(14) << "limb ns"
+              << std::setw(11) << "speedup\n";
+    bench_mul<64>();
+    bench_mul<256>();
+    bench_mul<512>();
+    bench_mul<1024>();
+    bench_mul<4096>();
+    bench_mul<8192>();
+    bench_mul<32768>();
+    bench_mul<131072>();
+    bench_mul<524288>();
+
+    std::cout << "\noperator/\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "N/2 bit ns"
+              << std::setw(14) << "1 word ns\n";
+    bench_div<128>();
+    bench_div<512>();
+    bench_div<2048>();
+    bench_div<8192>();
+
+    std::cout << "\nstr()\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "ns\n";
+    bench_str<128>();
+    bench_str<1024>();
+    bench_str<8192>();
+    bench_str<32768>();
+    bench_str<131072>();
+
+    std::cout << "\nrd_string()\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "ns\n";
+    bench_rd_string<128>();
+    bench_rd_string<1024>();
+    bench_rd_string<8192>();
+    bench_rd_string<131072>();
+
+    std::cout << "\nfma\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "upcast ns"
+              << std::setw(14) << "fma ns"
+              << std::setw(11) << "speedup\n";
+    bench_fma<128>();
+    bench_fma<1024>();
+    bench_fma<4096>();
+    bench_fma<16384>();
+
+    std::cout << "\npowmod\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "% ns"
+              << std::setw(14) << "mont ns"
+              << std::setw(11) << "speedup\n";
+    bench_powmod<256>();
+    bench_powmod<1024>();
+    bench_powmod<2048>();
+    bench_powmod<4096>();
+
+    std::cout << "\nmodint operator*\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "% ns"
+              << std::setw(14) << "barrett ns"
+              << std::setw(11) << "speedup\n";
+    bench_modint<128>();
+    bench_modint<512>();
+    bench_modint<2048>();
+    bench_modint<8192>();
+
+    std::cout << "\npool_allocator\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "std ns"
+              << std::setw(14) << "pool ns"
+              << std::setw(11) << "speedup\n";
+    bench_alloc<1024, exlib::pool_allocator>();
+    bench_alloc<65536, exlib::pool_allocator>();
+
+    std::cout << "\narena_allocator\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "std ns"
+              << std::setw(14) << "arena ns"
+              << std::setw(11) << "speedup\n";
+    bench_alloc<1024, exlib::arena_allocator>();
+    bench_alloc<65536, exlib::arena_allocator>();
+
+    std::cout << "\na * b + c - d\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "eager ns"
+              << std::setw(14) << "lazy ns"
+              << std::setw(11) << "speedup\n";
+    bench_expr<256>();
+    bench_expr<1024>();
+    bench_expr<4096>();
+
+    std::cout << "\nisqrt\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "bisect ns"
+              << std::setw(14) << "newton ns"
+              << std::setw(11) << "speedup\n";
+    bench_isqrt<256>();
+    bench_isqrt<1024>();
+    bench_isqrt<4096>();
+
+    std::cout << "\ngcd\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "euclid ns"
+              << std::setw(14) << "gcd ns"
+              << std::setw(11) << "speedup\n";
+    bench_gcd<128>();
+    bench_gcd<256>();
+    bench_gcd<1024>();
+    bench_gcd<4096>();
+
+    std::cout << "\nbit_width\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "bitwise ns"
+              << std::setw(14) << "scan ns"
+              << std::setw(11) << "speedup\n";
+    bench_bit_width<1024>();
+    bench_bit_width<4096>();
+
+    std::cout << "\nnext_prime\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "single ns"
+              << std::setw(14) << "sieved ns"
+              << std::setw(11) << "speedup\n";
+    bench_next_prime<256>();
+    bench_next_prime<512>();
+    bench_next_prime<1024>();
+
+    std::cout << "\nbigint\n"
+              << std::setw(8) << "bits"
+              << std::setw(14) << "8192 ns"
+              << std::setw(14) << "bigint ns"
+              << std::setw(11) << "speedup\n";
+    bench_bigint<100>();
+    bench_bigint<1000>();
+    bench_bigint<4000>();
+
+    std::cout << "\nto_bytes\n"
+              << std::setw(8) << "N"
+              << std::setw(14) << "shifted ns"
+              << std::setw(14) << "copied ns"
+              << std::setw(11) << "speedup\n";
+    bench_bytes<256>();
+    bench_bytes<1024>();
+    bench_bytes<4096>();
+
+    tune_mul_thresholds();
+    tune_div_thresholds();
+    return 0;
+}
@@ -1,4 +1,6 @@
 #ifdef __linux
+#include <cstdio>
+#include <cstdlib>
 #include <map>
 #include <new>
 #include <execinfo.h>
@@ -44,6 +46,7 @@ namespace zstl {
         }
 
         std::map<void*, alloc_info> allocated;
+        std::size_t allocations;
         bool enable;
     
         struct malloc_hook_init {
@@ -56,6 +59,11 @@ namespace zstl {
                 // after main
                 enable = false;
 
+                // MALLOC_HOOK_STATS=1 reports how many allocations main made
+                if (const char* stats = std::getenv("MALLOC_HOOK_STATS"); stats && *stats == '1') {
+                    printf("allocations: %zu\n", allocations);
+                }
+
                 if (!allocated.empty()) {
                     printf("memory leak!\n");
                     for (auto [ptr, info] : allocated) {
@@ -73,6 +81,7 @@ void *operator new(std::size_t size) {
     void* ptr = malloc(size);
     if (was_enable && ptr) {
         zstl::_malloc_hook::allocated.insert({ptr, {size, caller}});
+        ++zstl::_malloc_hook::allocations;
         // printf("new ptr = %p, size = %zd\n", ptr, size);
     }
     zstl::_malloc_hook::enable = was_enable;
@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// allocators for the Allocator parameter of integer and ndarray
+// both keep their memory per thread, so steady-state batches do not reach malloc
+
+namespace exlib {
+    namespace details {
+        // thread local bump arena, grown in doubling blocks that are kept across resets
+        struct arena_state {
+            struct block {
+                std::unique_ptr<std::byte[]> data;
+                std::size_t size = 0;
+                std::size_t used = 0;
+            };
+
+            struct mark {
+                std::size_t top;
+                std::size_t used;
+            };
+
+            inline static constexpr std::size_t min_block_size = 1 << 16;
+
+            std::vector<block> blocks;
+            std::size_t top = 0;
+
+            void* allocate(std::size_t bytes, std::size_t align) {
+                if (blocks.empty()) {
+                    blocks.emplace_back();
+                }
+                std::size_t offset = (blocks[top].used + align - 1) / align * align;
+                if (offset + bytes > blocks[top].size) {
+                    if (blocks[top].used != 0) {
+                        ++top;
+                    }
+                    if (top == blocks.size()) {
+                        blocks.emplace_back();
+                    }
+                    if (blocks[top].size < bytes) {
+                        std::size_t size = std::max({bytes, min_block_size, 2 * blocks[top > 0 ? top - 1 : 0].size});
+                        blocks[top].data.reset(new std::byte[size]);
+                        blocks[top].size = size;
+                    }
+                    offset = 0;
+                }
+                blocks[top].used = offset + bytes;
+                return blocks[top].data.get() + offset;
+            }
+
+            mark position() const noexcept {
+                return {top, blocks.empty() ? 0 : blocks[top].used};
+            }
+
+            void reset(mark m) noexcept {
+                for (std::size_t i = m.top + 1; i <= top && i < blocks.size(); ++i) {
+                    blocks[i].used = 0;
+                }
+                top = m.top;
+                if (!blocks.empty()) {
+                    blocks[top].used = m.used;
+                }
+            }
+
+            static arena_state& local() noexcept {
+                thread_local arena_state s;
+                return s;
+            }
+        };
+
+        // thread local free lists of equally sized blocks, one list per size in bytes
+        // blocks are separate allocations, so a block may be freed on another thread
+        struct pool_state {
+            struct node {
+                node* next;
+            };
+
+            struct bucket {
+                std::size_t bytes;
+                node* head;
+            };
+
+            // few distinct sizes are live at once, a linear scan beats hashing here
+            std::vector<bucket> buckets;
+
+            bucket* find(std::size_t bytes) noexcept {
+                for (auto& b : buckets) {
+                    if (b.bytes == bytes) {
+                        return &b;
+                    }
+                }
+                return nullptr;
+            }
+
+            void* allocate(std::size_t bytes) {
+                bucket* b = find(bytes);
+                if (b == nullptr) {
+                    buckets.push_back({bytes, nullptr});
+                } else if (b->head != nullptr) {
+                    return std::exchange(b->head, b->head->next);
+                }
+                return ::operator new(std::max(bytes, sizeof(node)));
+            }
+
+            // sizes this thread never allocated go straight back to the heap
+            void deallocate(void* p, std::size_t bytes) noexcept {
+                if (bucket* b = find(bytes)) {
+                    b->head = ::new (p) node{b->head};
+                } else {
+                    ::operator delete(p);
+                }
+            }
+
+            ~pool_state() {
+                for (auto& b : buckets) {
+                    for (node* p = b.head; p != nullptr;) {
+                        ::operator delete(std::exchange(p, p->next));
+                    }
+                }
+                torn_down() = true;
+            }
+
+            // set once this thread's pool is destroyed. trivially destructible, so it can
+            // still be read by thread locals destroyed later and by statics on the main thread
+            static bool& torn_down() noexcept {
+                thread_local bool flag = false;
+                return flag;
+            }
+
+            // null after teardown, callers then use the heap directly
+            static pool_state* local() noexcept {
+                if (torn_down()) {
+                    return nullptr;
+                }
+                thread_local pool_state s;
+                return &s;
+            }
+        };
+    }
+
+    // allocates from the thread local arena and never frees on its own, memory comes back
+    // when the enclosing arena_scope ends. values must not outlive that scope
+    template<class T>
+    struct arena_allocator {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "arena_allocator does not support over-aligned types");
+
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        arena_allocator() noexcept = default;
+
+        template<class U>
+        arena_allocator(const arena_allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(details::arena_state::local().allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, std::size_t) noexcept {}
+
+        template<class U>
+        bool operator==(const arena_allocator<U>&) const noexcept {
+            return true;
+        }
+    };
+
+    // rewinds the thread local arena to where it was when the scope began
+    struct arena_scope {
+        details::arena_state::mark _mark;
+
+        arena_scope() noexcept : _mark(details::arena_state::local().position()) {}
+
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+
+        ~arena_scope() {
+            details::arena_state::local().reset(_mark);
+        }
+    };
+
+    // recycles freed blocks by size, integer always asks for array_size words so
+    // every value of one type shares a list. blocks are returned at thread exit, values
+    // that outlive the pool (statics, later thread locals) use the heap from then on
+    template<class T>
+    struct pool_allocator {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "pool_allocator does not support over-aligned types");
+
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        pool_allocator() noexcept = default;
+
+        template<class U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            if (auto* pool = details::pool_state::local()) {
+                return static_cast<T*>(pool->allocate(n * sizeof(T)));
+            }
+            return static_cast<T*>(::operator new(std::max(n * sizeof(T), sizeof(details::pool_state::node))));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            if (auto* pool = details::pool_state::local()) {
+                pool->deallocate(p, n * sizeof(T));
+            } else {
+                ::operator delete(p);
+            }
+        }
+
+        template<class U>
+        bool operator==(const pool_allocator<U>&) const noexcept {
+            return true;
+        }
+    };
+}
@@ -0,0 +1,551 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <climits>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "integer.h"
+
+// arbitrary precision integers sized at run time. the value is a sign and a magnitude
+// trimmed to its top nonzero limb, so operations run over the limbs the value needs and
+// not over a fixed width. short magnitudes live in the object, longer ones on the heap
+
+namespace exlib {
+    template<class Word = std::uint64_t>
+    requires details::is_limb_v<Word>
+    struct basic_bigint {
+        using word_type = Word;
+        using self_type = basic_bigint;
+        using reference = self_type&;
+        using const_reference = const self_type&;
+
+        inline static constexpr std::size_t word_size = details::limb_bits<Word>;
+        // 128 bits stay inline
+        inline static constexpr std::size_t inline_size = std::max<std::size_t>(2, 128 / word_size);
+
+        std::array<word_type, inline_size> _inline{};
+        word_type* _heap = nullptr;
+        std::size_t _capacity = inline_size;
+        std::size_t _size = 0;
+        bool _neg = false;
+
+        constexpr basic_bigint() noexcept = default;
+
+        template<typename I>
+        requires std::is_integral_v<I>
+        constexpr basic_bigint(const I& i) noexcept {
+            using U = std::make_unsigned_t<I>;
+            U mag = static_cast<U>(i);
+            if constexpr (std::is_signed_v<I>) {
+                if (i < 0) {
+                    mag = static_cast<U>(U(0) - mag);
+                    _neg = true;
+                }
+            }
+            while (mag != 0) {
+                _inline[_size++] = static_cast<word_type>(mag);
+                if constexpr (sizeof(U) * CHAR_BIT > word_size) {
+                    mag = static_cast<U>(mag >> word_size);
+                } else {
+                    mag = 0;
+                }
+            }
+        }
+
+        // any integer converts exactly, its limbs are repacked into word_type first
+        template<class T>
+        requires is_integer_v<T>
+        constexpr basic_bigint(const T& x) {
+            const integer<T::size(), word_type, void, T::is_signed_v> v(x);
+            _reserve(v.array_size);
+            v._limb_magnitude(_data());
+            _size = v.array_size;
+            _neg = v.sign();
+            _trim();
+        }
+
+        // digits in base 2, 8, 10 or 16 with an optional leading '-'
+        constexpr explicit basic_bigint(std::string_view s, int base = 10) {
+            const std::from_chars_result res = _rd_chars(s.data(), s.data() + s.size(), base);
+            if (res.ec != std::errc{} || res.ptr != s.data() + s.size()) {
+                throw std::runtime_error("invalid bigint string");
+            }
+        }
+
+        constexpr basic_bigint(const_reference other) {
+            _assign_magnitude(other._data(), other._size, other._neg);
+        }
+
+        constexpr basic_bigint(self_type&& other) noexcept {
+            _steal(other);
+        }
+
+        constexpr reference operator=(const_reference other) {
+            if (&other != this) {
+                _assign_magnitude(other._data(), other._size, other._neg);
+            }
+            return *this;
+        }
+
+        constexpr reference operator=(self_type&& other) noexcept {
+            if (&other != this) {
+                delete[] _heap;
+                _heap = nullptr;
+                _capacity = inline_size;
+                _steal(other);
+            }
+            return *this;
+        }
+
+        constexpr ~basic_bigint() {
+            delete[] _heap;
+        }
+
+        constexpr word_type* _data() noexcept {
+            return _heap != nullptr ? _heap : _inline.data();
+        }
+
+        constexpr const word_type* _data() const noexcept {
+            return _heap != nullptr ? _heap : _inline.data();
+        }
+
+        // other is left as zero
+        constexpr void _steal(self_type& other) noexcept {
+            _inline = other._inline;
+            _heap = std::exchange(other._heap, nullptr);
+            _capacity = std::exchange(other._capacity, inline_size);
+            _size = std::exchange(other._size, 0);
+            _neg = std::exchange(other._neg, false);
+        }
+
+        // room for n limbs, the current limbs are kept
+        constexpr void _reserve(std::size_t n) {
+            if (n <= _capacity) {
+                return;
+            }
+            const std::size_t cap = std::max(n, 2 * _capacity);
+            word_type* p = new word_type[cap];
+            std::copy_n(_data(), _size, p);
+            delete[] _heap;
+            _heap = p;
+            _capacity = cap;
+        }
+
+        // drops the zero limbs on top, zero is never negative
+        constexpr void _trim() noexcept {
+            _size = details::limb_trim(_data(), _size);
+            if (_size == 0) {
+                _neg = false;
+            }
+        }
+
+        constexpr void _assign_magnitude(const word_type* mag, std::size_t n, bool neg) {
+            _size = 0;
+            _reserve(n);
+            std::copy_n(mag, n, _data());
+            _size = n;
+            _neg = neg;
+            _trim();
+        }
+
+        // number of limbs in use, 0 for zero
+        constexpr std::size_t limb_count() const noexcept {
+            return _size;
+        }
+
+        constexpr std::size_t bit_width() const noexcept {
+            return _size == 0 ? 0 : (_size - 1) * word_size + std::bit_width(_data()[_size - 1]);
+        }
+
+        constexpr bool sign() const noexcept {
+            return _neg;
+        }
+
+        constexpr explicit operator bool() const noexcept {
+            return _size != 0;
+        }
+
+        constexpr self_type abs() const {
+            self_type res = *this;
+            res._neg = false;
+            return res;
+        }
+
+        constexpr self_type operator-() const {
+            self_type res = *this;
+            res._neg = !_neg && _size != 0;
+            return res;
+        }
+
+        constexpr self_type operator+() const {
+            return *this;
+        }
+
+        // the value modulo 2^N in integer's two's complement
+        template<class T>
+        requires is_integer_v<T>
+        constexpr explicit operator T() const {
+            integer<T::size(), word_type, void, T::is_signed_v> res;
+            res._assign_magnitude(_data(), _size, _neg);
+            return T(res);
+        }
+
+        template<typename I>
+        requires std::is_integral_v<I>
+        constexpr explicit operator I() const noexcept {
+            using U = std::make_unsigned_t<I>;
+            U mag = 0;
+            for (std::size_t i = 0; i < _size && i * word_size < sizeof(U) * CHAR_BIT; ++i) {
+                mag |= static_cast<U>(static_cast<U>(_data()[i]) << (i * word_size));
+            }
+            return static_cast<I>(_neg ? static_cast<U>(U(0) - mag) : mag);
+        }
+
+        // -1, 0 or 1 for |a| against |b|
+        static constexpr int _compare_magnitude(const_reference a, const_reference b) noexcept {
+            if (a._size != b._size) {
+                return a._size < b._size ? -1 : 1;
+            }
+            return details::limb_cmp_n(a._data(), b._data(), a._size);
+        }
+
+        // r = |a| + |b|, r may be a or b
+        static constexpr void _add_magnitude(reference r, const_reference a, const_reference b) {
+            const bool swap = a._size < b._size;
+            const_reference x = swap ? b : a;
+            const_reference y = swap ? a : b;
+            const std::size_t n = x._size;
+            r._reserve(n);
+            const word_type carry = details::limb_add(r._data(), x._data(), n, y._data(), y._size);
+            r._size = n;
+            // grows only for a carry, so sums that fit stay inline
+            if (carry != 0) {
+                r._reserve(n + 1);
+                r._data()[n] = carry;
+                r._size = n + 1;
+            }
+        }
+
+        // r = ||a| - |b||, returns whether |a| < |b|, r may be a or b
+        static constexpr bool _sub_magnitude(reference r, const_reference a, const_reference b) {
+            const bool less = _compare_magnitude(a, b) < 0;
+            const_reference x = less ? b : a;
+            const_reference y = less ? a : b;
+            const std::size_t n = x._size;
+            r._reserve(n);
+            details::limb_sub(r._data(), x._data(), n, y._data(), y._size);
+            r._size = n;
+            return less;
+        }
+
+        // this += (-1)^neg * other
+        constexpr void _add_signed(const_reference other, bool neg) {
+            const bool self_neg = _neg;
+            if (self_neg == neg) {
+                _add_magnitude(*this, *this, other);
+            } else {
+                _neg = _sub_magnitude(*this, *this, other) ? neg : self_neg;
+            }
+            _trim();
+        }
+
+        constexpr reference operator+=(const_reference other) {
+            _add_signed(other, other._neg);
+            return *this;
+        }
+
+        constexpr reference operator-=(const_reference other) {
+            _add_signed(other, !other._neg);
+            return *this;
+        }
+
+        constexpr reference operator*=(const_reference other) {
+            return *this = *this * other;
+        }
+
+        constexpr reference operator/=(const_reference other) {
+            _divmod(*this, other, this, nullptr);
+            return *this;
+        }
+
+        constexpr reference operator%=(const_reference other) {
+            _divmod(*this, other, nullptr, this);
+            return *this;
+        }
+
+        constexpr reference operator++() {
+            return *this += 1;
+        }
+
+        constexpr reference operator--() {
+            return *this -= 1;
+        }
+
+        constexpr self_type operator++(int) {
+            self_type res = *this;
+            *this += 1;
+            return res;
+        }
+
+        constexpr self_type operator--(int) {
+            self_type res = *this;
+            *this -= 1;
+            return res;
+        }
+
+        friend constexpr self_type operator+(const_reference lhs, const_reference rhs) {
+            self_type res = lhs;
+            res += rhs;
+            return res;
+        }
+
+        friend constexpr self_type operator+(self_type&& lhs, const_reference rhs) {
+            lhs += rhs;
+            return std::move(lhs);
+        }
+
+        friend constexpr self_type operator-(const_reference lhs, const_reference rhs) {
+            self_type res = lhs;
+            res -= rhs;
+            return res;
+        }
+
+        friend constexpr self_type operator-(self_type&& lhs, const_reference rhs) {
+            lhs -= rhs;
+            return std::move(lhs);
+        }
+
+        friend constexpr self_type operator*(const_reference lhs, const_reference rhs) {
+            self_type res;
+            if (lhs._size == 0 || rhs._size == 0) {
+                return res;
+            }
+            const std::size_t n = lhs._size + rhs._size;
+            // a product that fits inline takes at most one limb more than it needs, so
+            // it is formed on the stack instead of reserving all n limbs
+            const bool fits = lhs.bit_width() + rhs.bit_width() <= inline_size * word_size;
+            std::array<word_type, inline_size + 1> local{};
+            word_type* r = local.data();
+            if (!fits) {
+                res._reserve(n);
+                r = res._data();
+            }
+            if (rhs._size == 1 || lhs._size == 1) {
+                const_reference x = rhs._size == 1 ? lhs : rhs;
+                const word_type y = (rhs._size == 1 ? rhs : lhs)._data()[0];
+                r[x._size] = details::limb_mul_1(r, x._data(), x._size, y);
+            } else {
+                details::limb_scratch<word_type> scratch(details::limb_mul_scratch_size(lhs._size, rhs._size));
+                details::limb_mul(r, lhs._data(), lhs._size, rhs._data(), rhs._size, scratch.data);
+            }
+            if (fits) {
+                std::copy_n(r, std::min(n, inline_size), res._inline.data());
+            }
+            res._size = fits ? std::min(n, inline_size) : n;
+            res._neg = lhs._neg != rhs._neg;
+            res._trim();
+            return res;
+        }
+
+        friend constexpr self_type operator/(const_reference lhs, const_reference rhs) {
+            self_type res;
+            _divmod(lhs, rhs, &res, nullptr);
+            return res;
+        }
+
+        friend constexpr self_type operator%(const_reference lhs, const_reference rhs) {
+            self_type res;
+            _divmod(lhs, rhs, nullptr, &res);
+            return res;
+        }
+
+        // quotient truncated toward zero and the remainder with the sign of this
+        constexpr std::pair<self_type, self_type> divmod(const_reference other) const {
+            std::pair<self_type, self_type> res;
+            _divmod(*this, other, &res.first, &res.second);
+            return res;
+        }
+
+        // either output may be null or alias an operand
+        static constexpr void _divmod(const_reference lhs, const_reference rhs, self_type* quotient, self_type* remainder) {
+            if (rhs._size == 0) {
+                throw std::runtime_error("divided by zero!");
+            }
+            const std::size_t an = lhs._size;
+            const std::size_t dn = rhs._size;
+            if (an < dn) {
+                if (remainder != nullptr) {
+                    *remainder = lhs;
+                }
+                if (quotient != nullptr) {
+                    *quotient = 0;
+                }
+                return;
+            }
+            self_type q, r;
+            q._reserve(an - dn + 1);
+            r._reserve(dn);
+            if (dn == 1) {
+                r._data()[0] = details::limb_divrem_1(q._data(), lhs._data(), an, rhs._data()[0]);
+            } else {
+                details::limb_scratch<word_type> scratch(details::limb_div_qr_scratch_size(an, dn));
+                details::limb_div_qr(q._data(), r._data(), lhs._data(), an, rhs._data(), dn, scratch.data);
+            }
+            q._size = an - dn + 1;
+            q._neg = lhs._neg != rhs._neg;
+            q._trim();
+            r._size = dn;
+            r._neg = lhs._neg;
+            r._trim();
+            if (quotient != nullptr) {
+                *quotient = std::move(q);
+            }
+            if (remainder != nullptr) {
+                *remainder = std::move(r);
+            }
+        }
+
+        constexpr reference operator<<=(std::size_t cnt) {
+            if (_size == 0 || cnt == 0) {
+                return *this;
+            }
+            const std::size_t words = cnt / word_size;
+            const std::size_t bits = cnt % word_size;
+            // exactly the limbs the result needs, the top one only when bits spill into it
+            const std::size_t n = (bit_width() + cnt + word_size - 1) / word_size;
+            _reserve(n);
+            word_type* p = _data();
+            if (bits != 0) {
+                const word_type high = details::limb_lshift(p + words, p, _size, bits);
+                if (n > _size + words) {
+                    p[_size + words] = high;
+                }
+            } else if (words != 0) {
+                std::copy_backward(p, p + _size, p + _size + words);
+            }
+            std::fill_n(p, words, static_cast<word_type>(0));
+            _size = n;
+            return *this;
+        }
+
+        // rounds toward negative infinity like the arithmetic shift of integer
+        constexpr reference operator>>=(std::size_t cnt) {
+            const std::size_t words = cnt / word_size;
+            const std::size_t bits = cnt % word_size;
+            if (words >= _size) {
+                *this = _neg ? -1 : 0;
+                return *this;
+            }
+            word_type* p = _data();
+            bool lost = std::any_of(p, p + words, [](word_type w) { return w != 0; });
+            if (bits != 0) {
+                lost |= details::limb_rshift(p, p + words, _size - words, bits) != 0;
+            } else if (words != 0) {
+                std::copy(p + words, p + _size, p);
+            }
+            const bool neg = _neg;
+            _size -= words;
+            _trim();
+            if (neg && lost) {
+                _add_signed(1, true);
+            }
+            return *this;
+        }
+
+        friend constexpr self_type operator<<(const_reference lhs, std::size_t cnt) {
+            self_type res = lhs;
+            res <<= cnt;
+            return res;
+        }
+
+        friend constexpr self_type operator>>(const_reference lhs, std::size_t cnt) {
+            self_type res = lhs;
+            res >>= cnt;
+            return res;
+        }
+
+        friend constexpr bool operator==(const_reference lhs, const_reference rhs) noexcept {
+            return lhs._neg == rhs._neg && _compare_magnitude(lhs, rhs) == 0;
+        }
+
+        friend constexpr std::strong_ordering operator<=>(const_reference lhs, const_reference rhs) noexcept {
+            if (lhs._neg != rhs._neg) {
+                return lhs._neg ? std::strong_ordering::less : std::strong_ordering::greater;
+            }
+            const int c = lhs._neg ? _compare_magnitude(rhs, lhs) : _compare_magnitude(lhs, rhs);
+            return c <=> 0;
+        }
+
+        // std::from_chars for [first, last) in base 2, 8, 10 or 16, this is only written on success
+        constexpr std::from_chars_result _rd_chars(const char* first, const char* last, int base) {
+            const bool neg = first != last && *first == '-';
+            const std::size_t bits = (base == 2) ? 1 : (base == 8) ? 3 : (base == 16) ? 4 : 0;
+            if (bits == 0 && base != 10) {
+                return {first, std::errc::invalid_argument};
+            }
+            const char* begin = first + neg;
+            const char* end = begin;
+            while (end != last && details::limb_digit_values[static_cast<unsigned char>(*end)] < base) {
+                ++end;
+            }
+            if (end == begin) {
+                return {first, std::errc::invalid_argument};
+            }
+            const std::size_t len = static_cast<std::size_t>(end - begin);
+            const std::size_t n = (bits == 0) ? details::limb_decimal_limbs<word_type>(len) : len * bits / word_size + 1;
+            _size = 0;
+            _reserve(n);
+            if (bits == 0) {
+                details::limb_from_decimal(_data(), n, begin, len);
+            } else {
+                details::limb_from_pow2(_data(), n, begin, len, bits);
+            }
+            _size = n;
+            _neg = neg;
+            _trim();
+            return {end, std::errc{}};
+        }
+
+        // digits in base 2, 8, 10 or 16 with a leading '-' for negative values, other bases
+        // throw as they are rejected when reading
+        constexpr std::string str(int base = 10) const {
+            const std::size_t bits = (base == 2) ? 1 : (base == 8) ? 3 : (base == 16) ? 4 : 0;
+            if (bits == 0 && base != 10) {
+                throw std::runtime_error("unsupported bigint base");
+            }
+            if (_size == 0) {
+                return "0";
+            }
+            std::string res;
+            if (bits == 0) {
+                details::limb_scratch<word_type> scratch(_size);
+                std::copy_n(_data(), _size, scratch.data);
+                res = details::limb_to_decimal(scratch.data, _size);
+            } else {
+                res.resize(details::limb_pow2_digits(_data(), _size, bits));
+                details::limb_to_pow2(res.data(), res.size(), _data(), _size, bits);
+            }
+            if (_neg) {
+                res.insert(res.begin(), '-');
+            }
+            return res;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const_reference val) {
+            os << val.str();
+            return os;
+        }
+    };
+
+    using bigint = basic_bigint<>;
+}
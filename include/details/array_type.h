@@ -2,15 +2,22 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
+// widths up to this many bits keep their words inline by default
+#ifndef EXLIB_INLINE_BITS
+#define EXLIB_INLINE_BITS 32768
+#endif
+
 namespace exlib {
     namespace details {
         template<typename T, std::size_t N>
         struct static_array : public std::array<T, N>{
             using base_class_type = std::array<T, N>;
 
-            static_array() noexcept {
+            constexpr static_array() noexcept {
 
             }
         };
@@ -19,12 +26,16 @@ namespace exlib {
         struct dynamic_array : public std::vector<T, Allocator>{
             using base_class_type = std::vector<T, Allocator>;
 
-            dynamic_array() noexcept 
+            constexpr dynamic_array() noexcept 
             : base_class_type(N)  {}
         
-            inline void fill(T value = 0) noexcept {
+            constexpr void fill(T value = 0) noexcept {
                 std::fill(this->begin(), this->end(), static_cast<T>(value));
             }
         };  
+
+        // void selects the inline static_array, wider values go to the heap
+        template<std::size_t N, class Word>
+        using default_allocator = std::conditional_t<(N <= EXLIB_INLINE_BITS), void, std::allocator<Word>>;
     }
 }
\ No newline at end of file
@@ -0,0 +1,357 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// word-level (limb) kernels shared by integer
+// every kernel works on little-endian arrays of unsigned words
+
+namespace exlib {
+    namespace details {
+        template<typename W>
+        inline constexpr bool is_limb_v = std::is_unsigned_v<W> && !std::is_same_v<W, bool>;
+
+        template<typename W>
+        concept limb_word = is_limb_v<W>;
+
+        template<limb_word W>
+        inline constexpr std::size_t limb_bits = sizeof(W) * CHAR_BIT;
+
+#if defined(__SIZEOF_INT128__)
+        inline constexpr bool has_int128 = true;
+        using uint128_type = unsigned __int128;
+#else
+        inline constexpr bool has_int128 = false;
+        using uint128_type = void;
+#endif
+
+        // unsigned type holding the full product of two limbs, void if there is none
+        template<limb_word W>
+        using double_limb_t = std::conditional_t<sizeof(W) == 1, std::uint16_t,
+                              std::conditional_t<sizeof(W) == 2, std::uint32_t,
+                              std::conditional_t<sizeof(W) == 4, std::uint64_t, uint128_type>>>;
+
+        // x + y + carry, carry is updated in place (0 or 1)
+        template<limb_word W>
+        constexpr W add_with_carry(W x, W y, W& carry) noexcept {
+#if defined(__clang__) && defined(__has_builtin)
+#if __has_builtin(__builtin_addcll)
+            if constexpr (std::is_same_v<W, unsigned long long>) {
+                if (!std::is_constant_evaluated()) {
+                    unsigned long long c;
+                    W s = __builtin_addcll(x, y, carry, &c);
+                    carry = c;
+                    return s;
+                }
+            }
+#endif
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+            W s;
+            bool c1 = __builtin_add_overflow(x, y, &s);
+            bool c2 = __builtin_add_overflow(s, carry, &s);
+            carry = c1 | c2;
+            return s;
+#else
+            W s = static_cast<W>(x + y);
+            W c1 = s < x;
+            s = static_cast<W>(s + carry);
+            carry = c1 | (s < carry);
+            return s;
+#endif
+        }
+
+        // x - y - borrow, borrow is updated in place (0 or 1)
+        template<limb_word W>
+        constexpr W sub_with_borrow(W x, W y, W& borrow) noexcept {
+#if defined(__clang__) && defined(__has_builtin)
+#if __has_builtin(__builtin_subcll)
+            if constexpr (std::is_same_v<W, unsigned long long>) {
+                if (!std::is_constant_evaluated()) {
+                    unsigned long long b;
+                    W d = __builtin_subcll(x, y, borrow, &b);
+                    borrow = b;
+                    return d;
+                }
+            }
+#endif
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+            W d;
+            bool b1 = __builtin_sub_overflow(x, y, &d);
+            bool b2 = __builtin_sub_overflow(d, borrow, &d);
+            borrow = b1 | b2;
+            return d;
+#else
+            W d = static_cast<W>(x - y);
+            W b1 = x < y;
+            W b2 = d < borrow;
+            d = static_cast<W>(d - borrow);
+            borrow = b1 | b2;
+            return d;
+#endif
+        }
+
+        // r[0, n) = a[0, n) + b[0, n) + carry, returns carry out
+        // r may alias a or b
+        template<limb_word W>
+        constexpr W limb_add_n(W* r, const W* a, const W* b, std::size_t n, W carry = 0) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = add_with_carry(a[i], b[i], carry);
+            }
+            return carry;
+        }
+
+        // r[0, n) = a[0, n) - b[0, n) - borrow, returns borrow out
+        template<limb_word W>
+        constexpr W limb_sub_n(W* r, const W* a, const W* b, std::size_t n, W borrow = 0) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = sub_with_borrow(a[i], b[i], borrow);
+            }
+            return borrow;
+        }
+
+        // r[0, n) = a[0, n) + (fill, fill, ...) + carry
+        // fill is 0 or ~0, i.e. the sign extension of a shorter operand
+        template<limb_word W>
+        constexpr W limb_add_fill(W* r, const W* a, std::size_t n, W fill, W carry = 0) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = add_with_carry(a[i], fill, carry);
+            }
+            return carry;
+        }
+
+        // r[0, n) = a[0, n) - (fill, fill, ...) - borrow
+        template<limb_word W>
+        constexpr W limb_sub_fill(W* r, const W* a, std::size_t n, W fill, W borrow = 0) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = sub_with_borrow(a[i], fill, borrow);
+            }
+            return borrow;
+        }
+
+        // low limb of x * y without promoting small words to signed int
+        template<limb_word W>
+        constexpr W mul_lo(W x, W y) noexcept {
+            using P = std::conditional_t<(sizeof(W) < sizeof(unsigned int)), unsigned int, W>;
+            return static_cast<W>(static_cast<P>(x) * static_cast<P>(y));
+        }
+
+        // r[0, n) = a[0, n) + b, returns carry out
+        template<limb_word W>
+        constexpr W limb_add_1(W* r, const W* a, std::size_t n, W b) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = add_with_carry(a[i], static_cast<W>(0), b);
+            }
+            return b;
+        }
+
+        // r[0, n) = a[0, n) - b, returns borrow out
+        template<limb_word W>
+        constexpr W limb_sub_1(W* r, const W* a, std::size_t n, W b) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = sub_with_borrow(a[i], static_cast<W>(0), b);
+            }
+            return b;
+        }
+
+        // r[0, n) = -a[0, n), returns 1 unless a is zero, r may equal a
+        template<limb_word W>
+        constexpr W limb_neg(W* r, const W* a, std::size_t n) noexcept {
+            W borrow = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = sub_with_borrow(static_cast<W>(0), a[i], borrow);
+            }
+            return borrow;
+        }
+
+        // unsigned three-way compare of a[0, n) and b[0, n), most significant limb first
+        template<limb_word W>
+        constexpr int limb_cmp_n(const W* a, const W* b, std::size_t n) noexcept {
+            for (std::size_t i = n; i-- > 0;) {
+                if (a[i] != b[i]) {
+                    return a[i] < b[i] ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        // r[0, n) = a[0, n) << cnt, 0 < cnt < limb_bits, returns the bits shifted out
+        // r may equal a
+        template<limb_word W>
+        constexpr W limb_lshift(W* r, const W* a, std::size_t n, std::size_t cnt) noexcept {
+            const std::size_t rcnt = limb_bits<W> - cnt;
+            W out = static_cast<W>(a[n - 1] >> rcnt);
+            for (std::size_t i = n - 1; i > 0; --i) {
+                r[i] = static_cast<W>((a[i] << cnt) | (a[i - 1] >> rcnt));
+            }
+            r[0] = static_cast<W>(a[0] << cnt);
+            return out;
+        }
+
+        // r[0, n) = a[0, n) >> cnt, 0 < cnt < limb_bits, high is shifted into the top limb
+        // returns the bits shifted out at the bottom, r may equal a
+        template<limb_word W>
+        constexpr W limb_rshift(W* r, const W* a, std::size_t n, std::size_t cnt, W high = 0) noexcept {
+            const std::size_t lcnt = limb_bits<W> - cnt;
+            W out = static_cast<W>(a[0] << lcnt);
+            for (std::size_t i = 0; i + 1 < n; ++i) {
+                r[i] = static_cast<W>((a[i] >> cnt) | (a[i + 1] << lcnt));
+            }
+            r[n - 1] = static_cast<W>((a[n - 1] >> cnt) | (high << lcnt));
+            return out;
+        }
+
+        // inverse of an odd d modulo 2^limb_bits
+        template<limb_word W>
+        constexpr W limb_binvert(W d) noexcept {
+            W inv = d;
+            for (std::size_t bits = 3; bits < limb_bits<W>; bits *= 2) {
+                inv = mul_lo(inv, static_cast<W>(2 - mul_lo(d, inv)));
+            }
+            return inv;
+        }
+
+        // full product x * y, the high limb is stored into hi
+        template<limb_word W>
+        constexpr W mul_wide(W x, W y, W& hi) noexcept {
+            if constexpr (!std::is_void_v<double_limb_t<W>>) {
+                using D = double_limb_t<W>;
+                D p = static_cast<D>(x) * static_cast<D>(y);
+                hi = static_cast<W>(p >> limb_bits<W>);
+                return static_cast<W>(p);
+            } else {
+#if defined(_MSC_VER) && defined(_M_X64)
+                if (!std::is_constant_evaluated()) {
+                    unsigned __int64 h;
+                    W lo = _umul128(x, y, &h);
+                    hi = h;
+                    return lo;
+                }
+#endif
+                constexpr std::size_t half = limb_bits<W> / 2;
+                constexpr W mask = (static_cast<W>(1) << half) - 1;
+                W x0 = x & mask, x1 = x >> half;
+                W y0 = y & mask, y1 = y >> half;
+                W p00 = x0 * y0, p01 = x0 * y1, p10 = x1 * y0, p11 = x1 * y1;
+                W mid = (p00 >> half) + (p01 & mask) + (p10 & mask);
+                hi = p11 + (p01 >> half) + (p10 >> half) + (mid >> half);
+                return (mid << half) | (p00 & mask);
+            }
+        }
+
+        // r[0, n) = a[0, n) * b, returns the high limb
+        template<limb_word W>
+        constexpr W limb_mul_1(W* r, const W* a, std::size_t n, W b) noexcept {
+            W carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                W hi;
+                W lo = mul_wide(a[i], b, hi);
+                W c = 0;
+                r[i] = add_with_carry(lo, carry, c);
+                carry = hi + c;
+            }
+            return carry;
+        }
+
+        // r[0, n) += a[0, n) * b, returns the high limb
+        template<limb_word W>
+        constexpr W limb_addmul_1(W* r, const W* a, std::size_t n, W b) noexcept {
+            W carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                W hi;
+                W lo = mul_wide(a[i], b, hi);
+                W c = 0;
+                lo = add_with_carry(lo, carry, c);
+                W c2 = 0;
+                r[i] = add_with_carry(r[i], lo, c2);
+                carry = hi + c + c2;
+            }
+            return carry;
+        }
+
+        // r[0, n) -= a[0, n) * b, returns the high limb that should be borrowed
+        template<limb_word W>
+        constexpr W limb_submul_1(W* r, const W* a, std::size_t n, W b) noexcept {
+            W carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                W hi;
+                W lo = mul_wide(a[i], b, hi);
+                W c = 0;
+                lo = add_with_carry(lo, carry, c);
+                W borrow = 0;
+                r[i] = sub_with_borrow(r[i], lo, borrow);
+                carry = hi + c + borrow;
+            }
+            return carry;
+        }
+
+        // schoolbook product r[0, an + bn) = a[0, an) * b[0, bn)
+        // r must not alias a or b
+        template<limb_word W>
+        constexpr void limb_mul_basecase(W* r, const W* a, std::size_t an, const W* b, std::size_t bn) noexcept {
+            r[an] = limb_mul_1(r, a, an, b[0]);
+            for (std::size_t i = 1; i < bn; ++i) {
+                r[an + i] = limb_addmul_1(r + i, a, an, b[i]);
+            }
+        }
+
+        // schoolbook square r[0, 2n) = a[0, n)^2, r must not alias a
+        // the products a[i] * a[j] for i < j are summed once and doubled
+        template<limb_word W>
+        constexpr void limb_sqr_basecase(W* r, const W* a, std::size_t n) noexcept {
+            std::fill(r, r + 2 * n, static_cast<W>(0));
+            for (std::size_t i = 0; i + 1 < n; ++i) {
+                r[i + n] = limb_addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+            }
+            limb_lshift(r, r, 2 * n, 1);
+            W carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                W hi;
+                W lo = mul_wide(a[i], a[i], hi);
+                r[2 * i] = add_with_carry(r[2 * i], lo, carry);
+                r[2 * i + 1] = add_with_carry(r[2 * i + 1], hi, carry);
+            }
+        }
+
+        // truncated product r[0, n) = a[0, an) * b[0, bn) mod 2^(n * bits)
+        // only the rows and columns below n are computed, r must not alias a or b
+        template<limb_word W>
+        constexpr void limb_mul_low(W* r, std::size_t n, const W* a, std::size_t an, const W* b, std::size_t bn) noexcept {
+            std::fill(r, r + n, static_cast<W>(0));
+            for (std::size_t i = 0; i < bn && i < n; ++i) {
+                if (b[i] == 0) {
+                    continue;
+                }
+                std::size_t len = std::min(an, n - i);
+                W carry = limb_addmul_1(r + i, a, len, b[i]);
+                if (i + len < n) {
+                    r[i + len] = carry;
+                }
+            }
+        }
+
+        // q[0, n) = a[0, n) / d for an odd d that is known to divide a exactly
+        // q may equal a
+        template<limb_word W>
+        constexpr void limb_divexact_1(W* q, const W* a, std::size_t n, W d) noexcept {
+            const W inv = limb_binvert(d);
+            W carry = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                W borrow = 0;
+                W x = sub_with_borrow(a[i], carry, borrow);
+                W qi = mul_lo(x, inv);
+                q[i] = qi;
+                W hi;
+                mul_wide(qi, d, hi);
+                carry = static_cast<W>(hi + borrow);
+            }
+        }
+    }
+}
\ No newline at end of file
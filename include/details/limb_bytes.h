@@ -0,0 +1,85 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "limb.h"
+
+// binary conversion of limb arrays, whole limbs are moved with memcpy and a byte swap
+// where the byte order asks for one, only a partial limb at the end goes byte by byte
+
+namespace exlib {
+    // how the sign of a value is laid out in bytes, magnitude leaves it to the caller
+    enum class byte_format {
+        twos_complement,
+        magnitude
+    };
+
+    namespace details {
+        // the bytes of x in reverse order, compilers turn the loop into one instruction
+        template<limb_word W>
+        constexpr W limb_byteswap(W x) noexcept {
+            if constexpr (sizeof(W) == 1) {
+                return x;
+            } else {
+                W r = 0;
+                for (std::size_t i = 0; i < sizeof(W); ++i) {
+                    r = static_cast<W>((r << 8) | (x & 0xff));
+                    x = static_cast<W>(x >> 8);
+                }
+                return r;
+            }
+        }
+
+        // byte k of a[0, n) counted from the least significant, fill past the end
+        template<limb_word W>
+        constexpr std::byte limb_byte_at(const W* a, std::size_t n, std::size_t k, std::byte fill) noexcept {
+            const std::size_t i = k / sizeof(W);
+            return i < n ? static_cast<std::byte>(a[i] >> (k % sizeof(W) * 8)) : fill;
+        }
+
+        // out[0, len) = the bytes of a[0, n) in the given order, extended with fill
+        template<limb_word W>
+        constexpr void limb_to_bytes(std::byte* out, std::size_t len, const W* a, std::size_t n, std::endian order, std::byte fill) noexcept {
+            const bool big = order == std::endian::big;
+            std::size_t k = 0;
+            if (!std::is_constant_evaluated()) {
+                const bool swap = order != std::endian::native;
+                for (const std::size_t full = std::min(n, len / sizeof(W)); k < full; ++k) {
+                    const W w = swap ? limb_byteswap(a[k]) : a[k];
+                    std::memcpy(out + (big ? len - (k + 1) * sizeof(W) : k * sizeof(W)), &w, sizeof(W));
+                }
+                k *= sizeof(W);
+            }
+            for (; k < len; ++k) {
+                out[big ? len - 1 - k : k] = limb_byte_at(a, n, k, fill);
+            }
+        }
+
+        // r[0, n) = the bytes in[0, len) in the given order, extended with fill or cut at n limbs
+        template<limb_word W>
+        constexpr void limb_from_bytes(W* r, std::size_t n, const std::byte* in, std::size_t len, std::endian order, std::byte fill) noexcept {
+            const bool big = order == std::endian::big;
+            std::size_t i = 0;
+            if (!std::is_constant_evaluated()) {
+                const bool swap = order != std::endian::native;
+                for (const std::size_t full = std::min(n, len / sizeof(W)); i < full; ++i) {
+                    W w;
+                    std::memcpy(&w, in + (big ? len - (i + 1) * sizeof(W) : i * sizeof(W)), sizeof(W));
+                    r[i] = swap ? limb_byteswap(w) : w;
+                }
+            }
+            for (; i < n; ++i) {
+                W w = 0;
+                for (std::size_t j = sizeof(W); j-- > 0;) {
+                    const std::size_t k = i * sizeof(W) + j;
+                    const std::byte b = k < len ? in[big ? len - 1 - k : k] : fill;
+                    w = static_cast<W>((w << 8) | static_cast<W>(b));
+                }
+                r[i] = w;
+            }
+        }
+    }
+}
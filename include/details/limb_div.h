@@ -0,0 +1,431 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+#include "limb.h"
+#include "limb_mul.h"
+
+// division kernels: single limb divisors, schoolbook long division
+// (knuth algorithm d), barrett division by a newton reciprocal and
+// barrett reduction modulo a fixed modulus
+// thresholds are in limbs, override them before including integer.h
+
+#ifndef EXLIB_DIV_BARRETT_THRESHOLD
+#define EXLIB_DIV_BARRETT_THRESHOLD 1536
+#endif
+
+// newton reciprocals fall back to schoolbook division below this size
+#ifndef EXLIB_DIV_INVERT_THRESHOLD
+#define EXLIB_DIV_INVERT_THRESHOLD 32
+#endif
+
+namespace exlib {
+    namespace details {
+        struct div_thresholds {
+            std::size_t barrett;
+            std::size_t invert = EXLIB_DIV_INVERT_THRESHOLD;
+        };
+
+        inline constexpr div_thresholds default_div_thresholds = {
+            EXLIB_DIV_BARRETT_THRESHOLD,
+            EXLIB_DIV_INVERT_THRESHOLD
+        };
+
+        // floor((hi * B + lo) / d) for hi < d, the remainder is stored into r
+        // only used to build reciprocals, so the fallback may go a bit at a time
+        template<limb_word W>
+        constexpr W div_2by1_plain(W hi, W lo, W d, W& r) noexcept {
+            if constexpr (!std::is_void_v<double_limb_t<W>>) {
+                using D = double_limb_t<W>;
+                D n = static_cast<D>(static_cast<D>(hi) << limb_bits<W>) | lo;
+                r = static_cast<W>(n % d);
+                return static_cast<W>(n / d);
+            } else {
+                W q = 0;
+                for (std::size_t i = 0; i < limb_bits<W>; ++i) {
+                    W top = hi >> (limb_bits<W> - 1);
+                    hi = (hi << 1) | (lo >> (limb_bits<W> - 1));
+                    lo <<= 1;
+                    q <<= 1;
+                    if (top || hi >= d) {
+                        hi -= d;
+                        q |= 1;
+                    }
+                }
+                r = hi;
+                return q;
+            }
+        }
+
+        // reciprocal floor((B^2 - 1) / d) - B of a normalized d (top bit set)
+        template<limb_word W>
+        constexpr W limb_invert(W d) noexcept {
+            W r;
+            return div_2by1_plain(static_cast<W>(~d), static_cast<W>(~static_cast<W>(0)), d, r);
+        }
+
+        // floor((u1 * B + u0) / d) for a normalized d with reciprocal v and u1 < d
+        // the remainder is stored into r (moller and granlund, 2011)
+        template<limb_word W>
+        constexpr W div_2by1(W u1, W u0, W d, W v, W& r) noexcept {
+            W q1;
+            W q0 = mul_wide(v, u1, q1);
+            W c = 0;
+            q0 = add_with_carry(q0, u0, c);
+            q1 = static_cast<W>(q1 + u1 + c + 1);
+            r = static_cast<W>(u0 - mul_lo(q1, d));
+            if (r > q0) {
+                q1 = static_cast<W>(q1 - 1);
+                r = static_cast<W>(r + d);
+            }
+            if (r >= d) {
+                q1 = static_cast<W>(q1 + 1);
+                r = static_cast<W>(r - d);
+            }
+            return q1;
+        }
+
+        // q[0, n) = a[0, n) / d for d != 0, returns the remainder, q may equal a
+        template<limb_word W>
+        constexpr W limb_divrem_1(W* q, const W* a, std::size_t n, W d) noexcept {
+            if (n == 0) {
+                return 0;
+            }
+            const std::size_t s = std::countl_zero(d);
+            d = static_cast<W>(d << s);
+            const W v = limb_invert(d);
+            W r = 0;
+            if (s == 0) {
+                for (std::size_t i = n; i-- > 0;) {
+                    q[i] = div_2by1(r, a[i], d, v, r);
+                }
+                return r;
+            }
+            // shift the dividend on the fly instead of copying it
+            const std::size_t rs = limb_bits<W> - s;
+            r = static_cast<W>(a[n - 1] >> rs);
+            for (std::size_t i = n; i-- > 0;) {
+                W u0 = static_cast<W>(a[i] << s);
+                if (i > 0) {
+                    u0 |= static_cast<W>(a[i - 1] >> rs);
+                }
+                q[i] = div_2by1(r, u0, d, v, r);
+            }
+            return static_cast<W>(r >> s);
+        }
+
+        // a[0, n) mod d for d != 0, limb_divrem_1 without the quotient
+        template<limb_word W>
+        constexpr W limb_mod_1(const W* a, std::size_t n, W d) noexcept {
+            if (n == 0) {
+                return 0;
+            }
+            const std::size_t s = std::countl_zero(d);
+            d = static_cast<W>(d << s);
+            const W v = limb_invert(d);
+            W r = 0;
+            if (s == 0) {
+                for (std::size_t i = n; i-- > 0;) {
+                    div_2by1(r, a[i], d, v, r);
+                }
+                return r;
+            }
+            const std::size_t rs = limb_bits<W> - s;
+            r = static_cast<W>(a[n - 1] >> rs);
+            for (std::size_t i = n; i-- > 0;) {
+                W u0 = static_cast<W>(a[i] << s);
+                if (i > 0) {
+                    u0 |= static_cast<W>(a[i - 1] >> rs);
+                }
+                div_2by1(r, u0, d, v, r);
+            }
+            return static_cast<W>(r >> s);
+        }
+
+        // limbs of scratch needed by limb_div_qr for an / dn limb operands
+        constexpr std::size_t limb_div_qr_scratch_size(std::size_t an, std::size_t dn) noexcept {
+            return an + 1 + dn;
+        }
+
+        // schoolbook long division, same contract as limb_div_qr
+        template<limb_word W>
+        constexpr void limb_div_qr_basecase(W* q, W* r, const W* a, std::size_t an, const W* d, std::size_t dn, W* scratch) noexcept {
+            W* u = scratch;
+            W* dd = u + an + 1;
+            const std::size_t s = std::countl_zero(d[dn - 1]);
+            if (s == 0) {
+                std::copy_n(d, dn, dd);
+                std::copy_n(a, an, u);
+                u[an] = 0;
+            } else {
+                limb_lshift(dd, d, dn, s);
+                u[an] = limb_lshift(u, a, an, s);
+            }
+
+            const W d1 = dd[dn - 1];
+            const W d0 = dd[dn - 2];
+            const W v = limb_invert(d1);
+            for (std::size_t j = an - dn + 1; j-- > 0;) {
+                W* uj = u + j;
+                const W u2 = uj[dn];
+                const W u1 = uj[dn - 1];
+                W qhat;
+                if (u2 >= d1) {
+                    // only u2 == d1 is possible, the estimate saturates and may be 2 too large
+                    qhat = static_cast<W>(~static_cast<W>(0));
+                } else {
+                    W rhat;
+                    qhat = div_2by1(u2, u1, d1, v, rhat);
+                    // refine with the second divisor limb, after which qhat is at most 1 too large
+                    for (;;) {
+                        W hi;
+                        W lo = mul_wide(qhat, d0, hi);
+                        if (hi < rhat || (hi == rhat && lo <= uj[dn - 2])) {
+                            break;
+                        }
+                        qhat = static_cast<W>(qhat - 1);
+                        W c = 0;
+                        rhat = add_with_carry(rhat, d1, c);
+                        if (c) {
+                            break;
+                        }
+                    }
+                }
+
+                W neg = 0;
+                uj[dn] = sub_with_borrow(u2, limb_submul_1(uj, dd, dn, qhat), neg);
+                while (neg) {
+                    qhat = static_cast<W>(qhat - 1);
+                    W c = limb_add_n(uj, uj, dd, dn);
+                    uj[dn] = add_with_carry(uj[dn], static_cast<W>(0), c);
+                    neg = static_cast<W>(!c);
+                }
+                if (q) {
+                    q[j] = qhat;
+                }
+            }
+
+            if (r) {
+                if (s == 0) {
+                    std::copy_n(u, dn, r);
+                } else {
+                    limb_rshift(r, u, dn, s);
+                }
+            }
+        }
+
+        // number of limbs of a[0, n) without the leading zeros
+        template<limb_word W>
+        constexpr std::size_t limb_trim(const W* a, std::size_t n) noexcept {
+            while (n > 0 && a[n - 1] == 0) {
+                --n;
+            }
+            return n;
+        }
+
+        // x[0, n + 1) ~ floor((B^2n - 1) / d) for a normalized d[0, n), off by a few units at most
+        // one newton step on the reciprocal of the top half of d
+        template<limb_word W>
+        constexpr void limb_invert_approx(W* x, const W* d, std::size_t n, const div_thresholds& th) {
+            if (n < th.invert || n < 4) {
+                limb_scratch<W> scratch(2 * n + limb_div_qr_scratch_size(2 * n, n));
+                W* ones = scratch.data;
+                std::fill(ones, ones + 2 * n, static_cast<W>(~static_cast<W>(0)));
+                if (n == 1) {
+                    x[0] = limb_invert(d[0]);
+                    x[1] = 1;
+                } else {
+                    limb_div_qr_basecase(x, static_cast<W*>(nullptr), ones, 2 * n, d, n, ones + 2 * n);
+                }
+                return;
+            }
+
+            // the top half is inverted with one guard limb, which keeps the
+            // quadratic newton error below a unit at every level
+            const std::size_t m = (n + 1) / 2 + 1;
+            const std::size_t l = n - m;
+            limb_scratch<W> scratch((m + 1) + (n + m + 1) + (n + m + 3));
+            W* xm = scratch.data;
+            W* t = xm + m + 1;
+            W* p = t + n + m + 1;
+            limb_invert_approx(xm, d + l, m, th);
+
+            // e = B^(n + m) - d * xm, a few B^n either way
+            limb_mul_alloc(t, d, n, xm, m + 1);
+            const bool e_neg = t[n + m] != 0;
+            t[n + m] = 0;
+            if (!e_neg) {
+                limb_neg(t, t, n + m);
+            }
+
+            // x = xm * B^l +- xm * |e| / B^2m
+            limb_mul_alloc(p, xm, m + 1, t, n + 2);
+            std::fill(x, x + l, static_cast<W>(0));
+            std::copy_n(xm, m + 1, x + l);
+            if (e_neg) {
+                limb_sub(x, x, n + 1, p + 2 * m, l + 2);
+            } else {
+                limb_add(x, x, n + 1, p + 2 * m, l + 2);
+            }
+        }
+
+        // v[0, n) = floor((B^2n - 1) / d) - B^n for a normalized d[0, n) (top bit set)
+        template<limb_word W>
+        constexpr void limb_invert_n(W* v, const W* d, std::size_t n, const div_thresholds& th = default_div_thresholds) {
+            const std::size_t en = 2 * n + 2;
+            limb_scratch<W> scratch((n + 1) + 2 * en);
+            W* y = scratch.data;
+            W* p = y + n + 1;
+            W* e = p + en;
+            limb_invert_approx(y, d, n, th);
+
+            // e = B^2n - 1 - d * y, then step y until 0 <= e < d
+            limb_mul_alloc(p, d, n, y, n + 1);
+            p[en - 1] = 0;
+            std::fill(e, e + 2 * n, static_cast<W>(~static_cast<W>(0)));
+            std::fill(e + 2 * n, e + en, static_cast<W>(0));
+            limb_sub_n(e, e, p, en);
+            auto e_below_d = [&] {
+                return std::all_of(e + n, e + en, [](W w) { return w == 0; }) && limb_cmp_n(e, d, n) < 0;
+            };
+            while (e[en - 1] >> (limb_bits<W> - 1)) {
+                limb_sub_1(y, y, n + 1, static_cast<W>(1));
+                limb_add(e, e, en, d, n);
+            }
+            while (!e_below_d()) {
+                limb_add_1(y, y, n + 1, static_cast<W>(1));
+                limb_sub(e, e, en, d, n);
+            }
+            std::copy_n(y, n, v);
+        }
+
+        // barrett division, same contract as limb_div_qr
+        // the dividend is consumed a divisor length at a time, each block costing two products
+        template<limb_word W>
+        constexpr void limb_div_qr_barrett(W* q, W* r, const W* a, std::size_t an, const W* d, std::size_t dn, const div_thresholds& th = default_div_thresholds) {
+            const std::size_t blocks = (an + dn) / dn;
+            const std::size_t un = blocks * dn;
+            limb_scratch<W> scratch(un + dn + dn + un + 2 * dn + 2 * dn + dn);
+            W* u = scratch.data;
+            W* dd = u + un;
+            W* v = dd + dn;
+            W* qt = v + dn;
+            W* p = qt + un;
+            W* qd = p + 2 * dn;
+            W* rem = qd + 2 * dn;
+
+            // normalize and pad the dividend with zeros to whole blocks
+            const std::size_t s = std::countl_zero(d[dn - 1]);
+            std::fill(u + an, u + un, static_cast<W>(0));
+            if (s == 0) {
+                std::copy_n(d, dn, dd);
+                std::copy_n(a, an, u);
+            } else {
+                limb_lshift(dd, d, dn, s);
+                u[an] = limb_lshift(u, a, an, s);
+            }
+            limb_invert_n(v, dd, dn, th);
+
+            // rem is the running remainder, always below d
+            // the top block is shorter than the divisor, so it is at most d + (d - 1)
+            std::copy_n(u + un - dn, dn, rem);
+            W* qtop = qt + un - dn;
+            std::fill(qtop, qtop + dn, static_cast<W>(0));
+            if (limb_cmp_n(rem, dd, dn) >= 0) {
+                limb_sub_n(rem, rem, dd, dn);
+                qtop[0] = 1;
+            }
+            for (std::size_t j = blocks - 1; j-- > 0;) {
+                const W* block = u + j * dn;
+                W* qj = qt + j * dn;
+
+                // qj = rem + floor(rem * v / B^dn) never exceeds floor((rem * B^dn + block) / d)
+                const std::size_t rn = limb_trim(rem, dn);
+                std::fill(p, p + 2 * dn, static_cast<W>(0));
+                if (rn > 0) {
+                    limb_mul_alloc(p, rem, rn, v, dn);
+                }
+                limb_add_n(qj, rem, p + dn, dn);
+
+                // p = rem * B^dn + block - qj * d, at most a few d
+                const std::size_t qn = limb_trim(qj, dn);
+                std::fill(qd, qd + dn + 1, static_cast<W>(0));
+                if (qn > 0) {
+                    limb_mul_alloc(qd, qj, qn, dd, dn);
+                }
+                W borrow = limb_sub_n(p, block, qd, dn);
+                p[dn] = static_cast<W>(rem[0] - qd[dn] - borrow);
+                while (p[dn] != 0 || limb_cmp_n(p, dd, dn) >= 0) {
+                    p[dn] = static_cast<W>(p[dn] - limb_sub_n(p, p, dd, dn));
+                    limb_add_1(qj, qj, dn, static_cast<W>(1));
+                }
+                std::copy_n(p, dn, rem);
+            }
+
+            if (q) {
+                std::copy_n(qt, an - dn + 1, q);
+            }
+            if (r) {
+                if (s == 0) {
+                    std::copy_n(rem, dn, r);
+                } else {
+                    limb_rshift(r, rem, dn, s);
+                }
+            }
+        }
+
+        // q[0, an - dn + 1) = a / d and r[0, dn) = a % d for an >= dn >= 2 and d[dn - 1] != 0
+        // q or r may be null when that result is not needed, neither may alias a or d
+        // scratch must hold limb_div_qr_scratch_size(an, dn) limbs
+        template<limb_word W>
+        constexpr void limb_div_qr(W* q, W* r, const W* a, std::size_t an, const W* d, std::size_t dn, W* scratch, const div_thresholds& th = default_div_thresholds) {
+            if (dn >= th.barrett && an - dn + 1 >= th.barrett && !std::is_constant_evaluated()) {
+                limb_div_qr_barrett(q, r, a, an, d, dn, th);
+            } else {
+                limb_div_qr_basecase(q, r, a, an, d, dn, scratch);
+            }
+        }
+
+        // reciprocal mu[0, n + 2) = floor(B^(2n) / m) of a fixed modulus m[0, n) with m[n - 1] != 0
+        template<limb_word W>
+        constexpr void limb_barrett_mu(W* mu, const W* m, std::size_t n) {
+            limb_scratch<W> t(2 * n + 1 + limb_div_qr_scratch_size(2 * n + 1, n));
+            std::fill(t.data, t.data + 2 * n, static_cast<W>(0));
+            t.data[2 * n] = 1;
+            if (n == 1) {
+                limb_divrem_1(mu, t.data, 3, m[0]);
+            } else {
+                limb_div_qr(mu, static_cast<W*>(nullptr), t.data, 2 * n + 1, m, n, t.data + 2 * n + 1);
+            }
+        }
+
+        // limbs of scratch needed by limb_barrett_reduce for an n limb modulus
+        constexpr std::size_t limb_barrett_reduce_scratch_size(std::size_t n) noexcept {
+            return 2 * n + 3 + n + 1;
+        }
+
+        // r[0, n) = x[0, 2n) mod m for x < B^(2n), with mu from limb_barrett_mu
+        // the quotient is estimated from the top n + 1 limbs of x times mu, keeping only the
+        // columns from n - 1 up. the estimate is at most three short, so the reduction costs
+        // two half products and a few subtractions. scratch must hold
+        // limb_barrett_reduce_scratch_size(n) limbs, r may alias x
+        template<limb_word W>
+        constexpr void limb_barrett_reduce(W* r, const W* x, const W* m, const W* mu, std::size_t n, W* scratch) noexcept {
+            W* q = scratch;
+            W* p = q + 2 * n + 3;
+            const W* q1 = x + n - 1;
+            std::fill(q + n - 1, q + 2 * n + 3, static_cast<W>(0));
+            for (std::size_t i = 0; i <= n; ++i) {
+                const std::size_t j = i + 1 < n ? n - 1 - i : 0;
+                q[i + n + 2] = limb_addmul_1(q + i + j, mu + j, n + 2 - j, q1[i]);
+            }
+            limb_mul_low(p, n + 1, q + n + 1, n + 2, m, n);
+            limb_sub_n(p, x, p, n + 1);
+            while (p[n] != 0 || limb_cmp_n(p, m, n) >= 0) {
+                p[n] -= limb_sub_n(p, p, m, n);
+            }
+            std::copy_n(p, n, r);
+        }
+    }
+}
@@ -0,0 +1,319 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "limb.h"
+#include "limb_mul.h"
+#include "limb_div.h"
+
+// gcd kernels on magnitudes: binary gcd for short operands, lehmer's algorithm
+// above EXLIB_GCD_LEHMER_THRESHOLD limbs, and the extended gcd, which runs
+// lehmer's algorithm at every size and carries the cofactor of the first operand
+// thresholds are in limbs, override them before including integer.h
+
+#ifndef EXLIB_GCD_LEHMER_THRESHOLD
+#define EXLIB_GCD_LEHMER_THRESHOLD 3
+#endif
+
+namespace exlib {
+    namespace details {
+        // trailing zero bits of a nonzero number
+        template<limb_word W>
+        constexpr std::size_t limb_ctz(const W* a) noexcept {
+            std::size_t i = 0;
+            while (a[i] == 0) {
+                ++i;
+            }
+            return i * limb_bits<W> + std::countr_zero(a[i]);
+        }
+
+        // a[0, n) >>= cnt for any cnt, returns the trimmed length
+        template<limb_word W>
+        constexpr std::size_t limb_rshift_trim(W* a, std::size_t n, std::size_t cnt) noexcept {
+            const std::size_t words = cnt / limb_bits<W>, bits = cnt % limb_bits<W>;
+            if (words >= n) {
+                return 0;
+            }
+            if (words > 0) {
+                std::copy(a + words, a + n, a);
+                n -= words;
+            }
+            if (bits > 0) {
+                limb_rshift(a, a, n, bits);
+            }
+            return limb_trim(a, n);
+        }
+
+        // binary gcd of two limbs
+        template<limb_word W>
+        constexpr W word_gcd(W x, W y) noexcept {
+            if (x == 0 || y == 0) {
+                return static_cast<W>(x | y);
+            }
+            const int k = std::countr_zero(static_cast<W>(x | y));
+            x = static_cast<W>(x >> std::countr_zero(x));
+            do {
+                y = static_cast<W>(y >> std::countr_zero(y));
+                if (x > y) {
+                    std::swap(x, y);
+                }
+                y = static_cast<W>(y - x);
+            } while (y != 0);
+            return static_cast<W>(x << k);
+        }
+
+        // g = gcd(a[0, an), b[0, bn)), returns its length, a and b are destroyed
+        // both operands are made odd, then the smaller is subtracted from the larger
+        // and the difference shifted right until they meet. g must not alias a or b
+        template<limb_word W>
+        constexpr std::size_t limb_gcd_binary(W* g, W* a, std::size_t an, W* b, std::size_t bn) noexcept {
+            an = limb_trim(a, an);
+            bn = limb_trim(b, bn);
+            if (an == 0 || bn == 0) {
+                std::copy_n(an == 0 ? b : a, an + bn, g);
+                return an + bn;
+            }
+            const std::size_t za = limb_ctz(a), zb = limb_ctz(b);
+            an = limb_rshift_trim(a, an, za);
+            bn = limb_rshift_trim(b, bn, zb);
+            while (an > 2 || bn > 2) {
+                const int c = an != bn ? (an < bn ? -1 : 1) : limb_cmp_n(a, b, an);
+                if (c == 0) {
+                    break;
+                }
+                if (c < 0) {
+                    std::swap(a, b);
+                    std::swap(an, bn);
+                }
+                const W borrow = limb_sub_n(a, a, b, bn);
+                limb_sub_1(a + bn, a + bn, an - bn, borrow);
+                an = limb_trim(a, an);
+                an = limb_rshift_trim(a, an, limb_ctz(a));
+            }
+            if (an <= 2 && bn <= 2) {
+                // the same on two limbs kept in registers
+                W al = a[0], ah = an == 2 ? a[1] : static_cast<W>(0);
+                W bl = b[0], bh = bn == 2 ? b[1] : static_cast<W>(0);
+                while ((ah != 0 || bh != 0) && (ah != bh || al != bl)) {
+                    if (ah < bh || (ah == bh && al < bl)) {
+                        std::swap(ah, bh);
+                        std::swap(al, bl);
+                    }
+                    W borrow = 0;
+                    al = sub_with_borrow(al, bl, borrow);
+                    ah = sub_with_borrow(ah, bh, borrow);
+                    if (al == 0) {
+                        al = static_cast<W>(ah >> std::countr_zero(ah));
+                        ah = 0;
+                    } else if (const int z = std::countr_zero(al); z > 0) {
+                        al = static_cast<W>((al >> z) | (ah << (limb_bits<W> - z)));
+                        ah = static_cast<W>(ah >> z);
+                    }
+                }
+                a[0] = ah == 0 ? word_gcd(al, bl) : al;
+                a[1] = ah;
+                an = ah == 0 ? 1 : 2;
+            }
+            const std::size_t k = std::min(za, zb), words = k / limb_bits<W>, bits = k % limb_bits<W>;
+            std::fill(g, g + words, static_cast<W>(0));
+            if (bits == 0) {
+                std::copy_n(a, an, g + words);
+            } else if (const W out = limb_lshift(g + words, a, an, bits); out != 0) {
+                g[words + an++] = out;
+            }
+            return words + an;
+        }
+
+        // digits for the single limb euclid in lehmer's algorithm, two bits short of
+        // a limb so that the sums in the quotient test still fit a signed 64 bit value
+        template<limb_word W>
+        inline constexpr std::size_t lehmer_bits = std::min<std::size_t>(limb_bits<W>, 64) - 2;
+
+        // bits [s, s + lehmer_bits) of x[0, n), zero above n
+        template<limb_word W>
+        constexpr std::int64_t limb_lehmer_digit(const W* x, std::size_t n, std::size_t s) noexcept {
+            const std::size_t i = s / limb_bits<W>, off = s % limb_bits<W>;
+            W d = i < n ? static_cast<W>(x[i] >> off) : static_cast<W>(0);
+            if (off > 0 && i + 1 < n) {
+                d |= static_cast<W>(x[i + 1] << (limb_bits<W> - off));
+            }
+            return static_cast<std::int64_t>(d & static_cast<W>((static_cast<W>(1) << lehmer_bits<W>) - 1));
+        }
+
+        // r[0, n) = u * a - v * b, which must be in [0, B^n)
+        template<limb_word W>
+        constexpr void limb_lehmer_sub(W* r, const W* a, W u, const W* b, W v, std::size_t n) noexcept {
+            limb_mul_1(r, a, n, u);
+            limb_submul_1(r, b, n, v);
+        }
+
+        // r[0, n) = u * a + v * b, returns the high limb
+        template<limb_word W>
+        constexpr W limb_lehmer_add(W* r, const W* a, W u, const W* b, W v, std::size_t n) noexcept {
+            const W hi = limb_mul_1(r, a, n, u);
+            return hi + limb_addmul_1(r, b, n, v);
+        }
+
+        // lehmer's algorithm (knuth 4.5.2 algorithm l). euclid runs on the leading
+        // lehmer_bits bits of both operands for as long as the quotients provably agree
+        // with the full ones, and the 2x2 matrix of those steps is then applied to the full
+        // numbers in a single pass. when Ext is set, s[0, sn) and sneg are the magnitude
+        // and sign of the cofactor with s * a = g mod b, whose matrix has the same entries
+        // up to sign, as the cofactors of a and b alternate in sign
+        template<bool Ext, limb_word W>
+        constexpr std::size_t limb_gcd_lehmer(W* g, const W* a, std::size_t an, const W* b, std::size_t bn, W* s = nullptr, std::size_t* sn = nullptr, bool* sneg = nullptr) {
+            an = limb_trim(a, an);
+            bn = limb_trim(b, bn);
+            const std::size_t n = std::max<std::size_t>({an, bn, 1}), m = Ext ? n + 2 : 0;
+            limb_scratch<W> t(4 * n + 4 * m + n + limb_div_qr_scratch_size(n, n));
+            W* x = t.data;
+            W* y = x + n;
+            W* nx = y + n;
+            W* ny = nx + n;
+            W* u0 = ny + n;
+            W* u1 = u0 + m;
+            W* nu0 = u1 + m;
+            W* nu1 = nu0 + m;
+            W* q = nu1 + m;
+            W* ds = q + n;
+            std::fill(x, x + 2 * n, static_cast<W>(0));
+            std::copy_n(a, an, x);
+            std::copy_n(b, bn, y);
+            std::size_t xn = an, yn = bn, un = 1;
+            bool neg = false;
+            if constexpr (Ext) {
+                std::fill(u0, u0 + 4 * m, static_cast<W>(0));
+                u0[0] = 1;
+            }
+            // x, y = y, x - q * y for a quotient q[0, qn), with u0, u1 = u1, u0 + q * u1
+            auto cofactor_step = [&](const W* qp, std::size_t qn) {
+                if constexpr (Ext) {
+                    qn = limb_trim(qp, qn);
+                    std::copy_n(u0, un, nu1);
+                    std::fill(nu1 + un, nu1 + m, static_cast<W>(0));
+                    const std::size_t u1n = limb_trim(u1, un);
+                    if (qn > 0 && u1n > 0) {
+                        limb_scratch<W> p(qn + u1n + limb_mul_scratch_size(qn, u1n));
+                        limb_mul(p.data, qp, qn, u1, u1n, p.data + qn + u1n);
+                        const std::size_t pn = limb_trim(p.data, qn + u1n);
+                        limb_add_1(nu1 + pn, nu1 + pn, m - pn, limb_add_n(nu1, nu1, p.data, pn));
+                    }
+                    un = std::max<std::size_t>(limb_trim(nu1, m), 1);
+                    std::swap(u0, u1);
+                    std::swap(u1, nu1);
+                    neg = !neg;
+                }
+            };
+            if (xn < yn || (xn == yn && limb_cmp_n(x, y, xn) < 0)) {
+                std::swap(x, y);
+                std::swap(xn, yn);
+                if constexpr (Ext) {
+                    std::swap(u0, u1);
+                    neg = !neg;
+                }
+            }
+            // without a cofactor the last two limbs are cheaper in binary
+            while (yn > 1 && (Ext || xn > 2)) {
+                const std::size_t shift = (xn - 1) * limb_bits<W> + std::bit_width(x[xn - 1]) - lehmer_bits<W>;
+                std::int64_t xh = limb_lehmer_digit(x, xn, shift), yh = limb_lehmer_digit(y, yn, shift);
+                std::int64_t ca = 1, cb = 0, cc = 0, cd = 1;
+                bool odd = false;
+                while (yh + cc > 0 && yh + cd > 0 && xh + ca >= 0 && xh + cb >= 0) {
+                    const std::int64_t qh = (xh + ca) / (yh + cc);
+                    if (qh != (xh + cb) / (yh + cd)) {
+                        break;
+                    }
+                    ca = std::exchange(cc, ca - qh * cc);
+                    cb = std::exchange(cd, cb - qh * cd);
+                    xh = std::exchange(yh, xh - qh * yh);
+                    odd = !odd;
+                }
+                if (cb == 0) {
+                    // no quotient was certain, take a full division step
+                    limb_div_qr(q, nx, x, xn, y, yn, ds);
+                    std::fill(nx + yn, nx + xn, static_cast<W>(0));
+                    cofactor_step(q, xn - yn + 1);
+                    std::swap(x, y);
+                    std::swap(y, nx);
+                    xn = yn;
+                    yn = limb_trim(y, yn);
+                    continue;
+                }
+                const W ua = static_cast<W>(ca < 0 ? -ca : ca), ub = static_cast<W>(cb < 0 ? -cb : cb);
+                const W uc = static_cast<W>(cc < 0 ? -cc : cc), ud = static_cast<W>(cd < 0 ? -cd : cd);
+                if (odd) {
+                    limb_lehmer_sub(nx, y, ub, x, ua, xn);
+                    limb_lehmer_sub(ny, x, uc, y, ud, xn);
+                } else {
+                    limb_lehmer_sub(nx, x, ua, y, ub, xn);
+                    limb_lehmer_sub(ny, y, ud, x, uc, xn);
+                }
+                std::swap(x, nx);
+                std::swap(y, ny);
+                xn = limb_trim(x, xn);
+                yn = limb_trim(y, xn);
+                if constexpr (Ext) {
+                    const W h0 = limb_lehmer_add(nu0, u0, ua, u1, ub, un);
+                    const W h1 = limb_lehmer_add(nu1, u0, uc, u1, ud, un);
+                    nu0[un] = h0;
+                    nu1[un] = h1;
+                    un += h0 != 0 || h1 != 0;
+                    std::swap(u0, nu0);
+                    std::swap(u1, nu1);
+                    neg = neg != odd;
+                }
+            }
+            if (yn > 1) {
+                return limb_gcd_binary(g, x, xn, y, yn);
+            }
+            if (yn == 1) {
+                // single limb divisor, finish on limbs, with euclid when the cofactor is needed
+                W r = limb_divrem_1(q, x, xn, y[0]), d = y[0];
+                if constexpr (Ext) {
+                    cofactor_step(q, xn);
+                    while (r != 0) {
+                        const W qw = static_cast<W>(d / r);
+                        d = static_cast<W>(d - mul_lo(qw, r));
+                        std::swap(d, r);
+                        cofactor_step(&qw, 1);
+                    }
+                } else {
+                    d = word_gcd(d, r);
+                }
+                x[0] = d;
+                xn = 1;
+            }
+            std::copy_n(x, xn, g);
+            if constexpr (Ext) {
+                *sn = limb_trim(u0, un);
+                std::copy_n(u0, *sn, s);
+                *sneg = neg && *sn != 0;
+            }
+            return xn;
+        }
+
+        // g = gcd(a[0, an), b[0, bn)), returns its length, g needs max(an, bn) limbs
+        template<limb_word W>
+        constexpr std::size_t limb_gcd(W* g, const W* a, std::size_t an, const W* b, std::size_t bn) {
+            an = limb_trim(a, an);
+            bn = limb_trim(b, bn);
+            if (std::max(an, bn) >= EXLIB_GCD_LEHMER_THRESHOLD) {
+                return limb_gcd_lehmer<false>(g, a, an, b, bn);
+            }
+            limb_scratch<W> t(an + bn);
+            std::copy_n(a, an, t.data);
+            std::copy_n(b, bn, t.data + an);
+            return limb_gcd_binary(g, t.data, an, t.data + an, bn);
+        }
+
+        // g = gcd(a[0, an), b[0, bn)) as limb_gcd, and s[0, sn) negated when sneg is set
+        // with s * a = g mod b and |s| <= max(b / g, 1). s needs max(an, bn) + 2 limbs
+        template<limb_word W>
+        constexpr std::size_t limb_gcdext(W* g, W* s, std::size_t& sn, bool& sneg, const W* a, std::size_t an, const W* b, std::size_t bn) {
+            return limb_gcd_lehmer<true>(g, a, an, b, bn, s, &sn, &sneg);
+        }
+    }
+}
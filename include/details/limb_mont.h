@@ -0,0 +1,114 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+#include "limb.h"
+#include "limb_mul.h"
+
+// montgomery kernels for an odd modulus m[0, n) with R = B^n
+// operands are reduced, i.e. below m, and so are the results
+
+namespace exlib {
+    namespace details {
+        // -m^-1 mod B for an odd m0, the factor that clears one limb per reduction step
+        template<limb_word W>
+        constexpr W limb_mont_minv(W m0) noexcept {
+            return static_cast<W>(static_cast<W>(0) - limb_binvert(m0));
+        }
+
+        // r[0, n) = a - m if sub is set and a otherwise, the same pass either way
+        template<limb_word W>
+        constexpr void limb_mont_csub(W* r, const W* a, const W* m, std::size_t n, bool sub) noexcept {
+            const W mask = static_cast<W>(static_cast<W>(0) - static_cast<W>(sub));
+            W borrow = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                r[i] = sub_with_borrow(a[i], static_cast<W>(m[i] & mask), borrow);
+            }
+        }
+
+        // r[0, n) = a * b / R mod m, coarsely integrated operand scanning (cios)
+        // each row adds a * b[i] and the multiple of m that clears the low limb in one
+        // pass, dropping that limb as it goes. t must hold n + 1 limbs, r may alias a or b
+        template<limb_word W>
+        constexpr void limb_mont_mul_cios(W* r, const W* a, const W* b, const W* m, std::size_t n, W minv, W* t) noexcept {
+            std::fill(t, t + n + 1, static_cast<W>(0));
+            for (std::size_t i = 0; i < n; ++i) {
+                const W bi = b[i];
+                const W u = mul_lo(static_cast<W>(t[0] + mul_lo(a[0], bi)), minv);
+                W c1 = 0, c2 = 0;
+                for (std::size_t j = 0; j < n; ++j) {
+                    W h1, h2, k1 = 0, k2 = 0;
+                    W s = add_with_carry(t[j], mul_wide(a[j], bi, h1), k1);
+                    s = add_with_carry(s, c1, k2);
+                    c1 = static_cast<W>(h1 + k1 + k2);
+                    k1 = 0, k2 = 0;
+                    s = add_with_carry(s, mul_wide(m[j], u, h2), k1);
+                    s = add_with_carry(s, c2, k2);
+                    c2 = static_cast<W>(h2 + k1 + k2);
+                    if (j > 0) {
+                        t[j - 1] = s;
+                    }
+                }
+                W carry = 0;
+                t[n - 1] = add_with_carry(t[n], c1, carry);
+                W carry2 = 0;
+                t[n - 1] = add_with_carry(t[n - 1], c2, carry2);
+                t[n] = static_cast<W>(carry + carry2);
+            }
+            // the sum is below 2m here
+            limb_mont_csub(r, t, m, n, t[n] != 0 || limb_cmp_n(t, m, n) >= 0);
+        }
+
+        // r[0, n) = t / R mod m for t[0, 2n) < m * R, t is destroyed
+        template<limb_word W>
+        constexpr void limb_mont_redc(W* r, W* t, const W* m, std::size_t n, W minv) noexcept {
+            W top = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const W u = mul_lo(t[i], minv);
+                W carry = top;
+                t[i + n] = add_with_carry(t[i + n], limb_addmul_1(t + i, m, n, u), carry);
+                top = carry;
+            }
+            limb_mont_csub(r, t + n, m, n, top != 0 || limb_cmp_n(t + n, m, n) >= 0);
+        }
+
+        // r[0, n) = a * b / R mod m, r may alias a or b
+        // a subquadratic product does not pay off here since the reduction stays quadratic
+        template<limb_word W>
+        constexpr void limb_mont_mul(W* r, const W* a, const W* b, const W* m, std::size_t n, W minv) {
+            limb_scratch<W> t(n + 1);
+            limb_mont_mul_cios(r, a, b, m, n, minv, t.data);
+        }
+
+        // r[0, n) = a * a / R mod m, r may alias a
+        // small squares skip the repeated cross products and reduce afterwards
+        template<limb_word W>
+        constexpr void limb_mont_sqr(W* r, const W* a, const W* m, std::size_t n, W minv, const mul_thresholds& th = default_mul_thresholds) {
+            if (n < th.karatsuba) {
+                limb_scratch<W> t(2 * n);
+                limb_sqr_basecase(t.data, a, n);
+                limb_mont_redc(r, t.data, m, n, minv);
+            } else {
+                limb_scratch<W> t(n + 1);
+                limb_mont_mul_cios(r, a, a, m, n, minv, t.data);
+            }
+        }
+
+        // r[0, n) = a + b mod m, r may alias a or b
+        template<limb_word W>
+        constexpr void limb_mont_add(W* r, const W* a, const W* b, const W* m, std::size_t n) noexcept {
+            W carry = limb_add_n(r, a, b, n);
+            if (carry != 0 || limb_cmp_n(r, m, n) >= 0) {
+                limb_sub_n(r, r, m, n);
+            }
+        }
+
+        // r[0, n) = a - b mod m, r may alias a or b
+        template<limb_word W>
+        constexpr void limb_mont_sub(W* r, const W* a, const W* b, const W* m, std::size_t n) noexcept {
+            if (limb_sub_n(r, a, b, n) != 0) {
+                limb_add_n(r, r, m, n);
+            }
+        }
+    }
+}
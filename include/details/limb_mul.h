@@ -0,0 +1,362 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "limb.h"
+#include "limb_ntt.h"
+
+// subquadratic multiplication kernels: karatsuba, toom-3 and ntt
+// thresholds are in limbs, override them before including integer.h
+
+#ifndef EXLIB_MUL_KARATSUBA_THRESHOLD
+#define EXLIB_MUL_KARATSUBA_THRESHOLD 24
+#endif
+
+#ifndef EXLIB_MUL_TOOM3_THRESHOLD
+#define EXLIB_MUL_TOOM3_THRESHOLD 320
+#endif
+
+#ifndef EXLIB_MUL_NTT_THRESHOLD
+#define EXLIB_MUL_NTT_THRESHOLD 2048
+#endif
+
+// integer keeps the truncated schoolbook product below this operand size
+#ifndef EXLIB_MUL_FULL_PRODUCT_THRESHOLD
+#define EXLIB_MUL_FULL_PRODUCT_THRESHOLD 96
+#endif
+
+namespace exlib {
+    namespace details {
+        struct mul_thresholds {
+            std::size_t karatsuba;
+            std::size_t toom3;
+            std::size_t full_product = EXLIB_MUL_FULL_PRODUCT_THRESHOLD;
+            std::size_t ntt = EXLIB_MUL_NTT_THRESHOLD;
+        };
+
+        inline constexpr mul_thresholds default_mul_thresholds = {
+            EXLIB_MUL_KARATSUBA_THRESHOLD,
+            EXLIB_MUL_TOOM3_THRESHOLD,
+            EXLIB_MUL_FULL_PRODUCT_THRESHOLD,
+            EXLIB_MUL_NTT_THRESHOLD
+        };
+
+        // thread local stack of limb buffers, released in LIFO order
+        // blocks are kept around so steady-state multiplications do not allocate
+        template<limb_word W>
+        struct limb_scratch_stack {
+            struct block {
+                std::unique_ptr<W[]> data;
+                std::size_t size = 0;
+                std::size_t used = 0;
+            };
+
+            std::vector<block> blocks;
+            std::size_t top = 0;
+
+            W* acquire(std::size_t n) {
+                if (blocks.empty()) {
+                    blocks.emplace_back();
+                }
+                if (blocks[top].size - blocks[top].used < n) {
+                    if (blocks[top].used != 0) {
+                        ++top;
+                    }
+                    if (top == blocks.size()) {
+                        blocks.emplace_back();
+                    }
+                    if (blocks[top].size < n) {
+                        std::size_t size = std::max(n, 2 * blocks[top > 0 ? top - 1 : 0].size);
+                        blocks[top].data.reset(new W[size]);
+                        blocks[top].size = size;
+                    }
+                }
+                W* ptr = blocks[top].data.get() + blocks[top].used;
+                blocks[top].used += n;
+                return ptr;
+            }
+
+            void release(std::size_t n) noexcept {
+                blocks[top].used -= n;
+                if (blocks[top].used == 0 && top != 0) {
+                    --top;
+                }
+            }
+        };
+
+        // constant evaluation cannot reach the thread local stack and allocates instead
+        template<limb_word W>
+        struct limb_scratch {
+            W* data;
+            std::size_t size;
+
+            constexpr explicit limb_scratch(std::size_t n)
+            : data(nullptr), size(n) {
+                if (std::is_constant_evaluated()) {
+                    data = new W[n + 1]();
+                } else {
+                    data = stack().acquire(n);
+                }
+            }
+
+            limb_scratch(const limb_scratch&) = delete;
+            limb_scratch& operator=(const limb_scratch&) = delete;
+
+            constexpr ~limb_scratch() noexcept {
+                if (std::is_constant_evaluated()) {
+                    delete[] data;
+                } else {
+                    stack().release(size);
+                }
+            }
+
+            static limb_scratch_stack<W>& stack() noexcept {
+                thread_local limb_scratch_stack<W> s;
+                return s;
+            }
+        };
+
+        // limbs of scratch needed by limb_mul_n for n limb operands
+        // the ntt tier keeps its own buffers, this covers the toom-3 fallback past ntt_max_length
+        constexpr std::size_t limb_mul_n_scratch_size(std::size_t n, const mul_thresholds& th = default_mul_thresholds) noexcept {
+            if (n < th.karatsuba) {
+                return 0;
+            }
+            if (n < th.toom3) {
+                std::size_t h = n / 2;
+                std::size_t l = n - h;
+                return 6 * l + 1 + std::max(limb_mul_n_scratch_size(h, th), limb_mul_n_scratch_size(l, th));
+            }
+            std::size_t k = (n + 2) / 3;
+            std::size_t l = n - 2 * k;
+            return 6 * (k + 1) + 3 * (2 * k + 2) + std::max({limb_mul_n_scratch_size(k, th), limb_mul_n_scratch_size(l, th), limb_mul_n_scratch_size(k + 1, th)});
+        }
+
+        template<limb_word W>
+        constexpr void limb_mul_n(W* r, const W* a, const W* b, std::size_t n, W* scratch, const mul_thresholds& th = default_mul_thresholds);
+
+        // r[0, an) = a[0, an) + b[0, bn) for an >= bn, returns carry out
+        template<limb_word W>
+        constexpr W limb_add(W* r, const W* a, std::size_t an, const W* b, std::size_t bn) noexcept {
+            W carry = limb_add_n(r, a, b, bn);
+            return limb_add_1(r + bn, a + bn, an - bn, carry);
+        }
+
+        // r[0, an) = a[0, an) - b[0, bn) for an >= bn, returns borrow out
+        template<limb_word W>
+        constexpr W limb_sub(W* r, const W* a, std::size_t an, const W* b, std::size_t bn) noexcept {
+            W borrow = limb_sub_n(r, a, b, bn);
+            return limb_sub_1(r + bn, a + bn, an - bn, borrow);
+        }
+
+        // r[0, n) = |a[0, n) - b[0, n)|, returns true if a < b
+        template<limb_word W>
+        constexpr bool limb_abs_sub_n(W* r, const W* a, const W* b, std::size_t n) noexcept {
+            if (limb_cmp_n(a, b, n) < 0) {
+                limb_sub_n(r, b, a, n);
+                return true;
+            }
+            limb_sub_n(r, a, b, n);
+            return false;
+        }
+
+        // r[0, 2n) = a * b with a = a0 + a1 * B^h
+        // a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 - (a0 - a1) * (b0 - b1)
+        template<limb_word W>
+        constexpr void limb_mul_karatsuba(W* r, const W* a, const W* b, std::size_t n, W* scratch, const mul_thresholds& th) {
+            const std::size_t h = n / 2;
+            const std::size_t l = n - h;
+            W* da = scratch;
+            W* db = da + l;
+            W* mid = db + l;
+            W* t = mid + 2 * l;
+            W* next = t + 2 * l + 1;
+
+            // |a0 - a1| and |b0 - b1|, the low halves zero extended to l limbs
+            bool neg = false;
+            for (auto [x, d] : {std::pair{a, da}, std::pair{b, db}}) {
+                bool x_neg;
+                if (h == l) {
+                    x_neg = limb_abs_sub_n(d, x, x + h, l);
+                } else if (x[n - 1] != 0 || limb_cmp_n(x, x + h, h) < 0) {
+                    // l == h + 1, so x0 < x1 whenever the top limb of x1 is set
+                    W borrow = limb_sub_n(d, x + h, x, h);
+                    d[h] = static_cast<W>(x[n - 1] - borrow);
+                    x_neg = true;
+                } else {
+                    limb_sub_n(d, x, x + h, h);
+                    d[h] = 0;
+                    x_neg = false;
+                }
+                neg ^= x_neg;
+            }
+
+            limb_mul_n(r, a, b, h, next, th);
+            limb_mul_n(r + 2 * h, a + h, b + h, l, next, th);
+            limb_mul_n(mid, da, db, l, next, th);
+
+            // t = z0 + z2 -/+ (a0 - a1) * (b0 - b1)
+            t[2 * l] = limb_add(t, r + 2 * h, 2 * l, r, 2 * h);
+            if (neg) {
+                t[2 * l] += limb_add_n(t, t, mid, 2 * l);
+            } else {
+                t[2 * l] -= limb_sub_n(t, t, mid, 2 * l);
+            }
+
+            W carry = limb_add_n(r + h, r + h, t, 2 * l + 1);
+            limb_add_1(r + h + 2 * l + 1, r + h + 2 * l + 1, 2 * n - h - 2 * l - 1, carry);
+        }
+
+        // e[0, k + 1) = x0 + c1 * x1 + c2 * x2, x0 and x1 have k limbs and x2 has l limbs
+        template<limb_word W>
+        constexpr void limb_toom3_eval(W* e, const W* x, std::size_t k, std::size_t l, W c1, W c2) noexcept {
+            std::copy(x, x + k, e);
+            e[k] = limb_addmul_1(e, x + k, k, c1);
+            W carry = limb_addmul_1(e, x + 2 * k, l, c2);
+            limb_add_1(e + l, e + l, k + 1 - l, carry);
+        }
+
+        // r[0, 2n) = a * b by toom-3 with evaluation points 0, 1, 2, 3 and infinity
+        // the points are all non-negative, so every intermediate value stays unsigned
+        template<limb_word W>
+        constexpr void limb_mul_toom3(W* r, const W* a, const W* b, std::size_t n, W* scratch, const mul_thresholds& th) {
+            const std::size_t k = (n + 2) / 3;
+            const std::size_t l = n - 2 * k;
+            const std::size_t m = 2 * k + 2;
+            W* ea = scratch;
+            W* eb = ea + 3 * (k + 1);
+            W* v1 = eb + 3 * (k + 1);
+            W* v2 = v1 + m;
+            W* v3 = v2 + m;
+            W* next = v3 + m;
+
+            for (auto [x, e] : {std::pair{a, ea}, std::pair{b, eb}}) {
+                limb_toom3_eval(e, x, k, l, static_cast<W>(1), static_cast<W>(1));
+                limb_toom3_eval(e + (k + 1), x, k, l, static_cast<W>(2), static_cast<W>(4));
+                limb_toom3_eval(e + 2 * (k + 1), x, k, l, static_cast<W>(3), static_cast<W>(9));
+            }
+
+            // r0 = v(0) and r4 = v(inf) go straight into place
+            W* r0 = r;
+            W* r4 = r + 4 * k;
+            limb_mul_n(r0, a, b, k, next, th);
+            limb_mul_n(r4, a + 2 * k, b + 2 * k, l, next, th);
+            std::fill(r + 2 * k, r + 4 * k, static_cast<W>(0));
+
+            limb_mul_n(v1, ea, eb, k + 1, next, th);
+            limb_mul_n(v2, ea + (k + 1), eb + (k + 1), k + 1, next, th);
+            limb_mul_n(v3, ea + 2 * (k + 1), eb + 2 * (k + 1), k + 1, next, th);
+
+            // q(x) = (v(x) - r0 - r4 * x^4) / x = r1 + r2 * x + r3 * x^2
+            limb_sub(v1, v1, m, r0, 2 * k);
+            limb_sub(v1, v1, m, r4, 2 * l);
+
+            limb_sub(v2, v2, m, r0, 2 * k);
+            limb_sub_1(v2 + 2 * l, v2 + 2 * l, m - 2 * l, limb_submul_1(v2, r4, 2 * l, static_cast<W>(16)));
+            limb_rshift(v2, v2, m, 1);
+
+            limb_sub(v3, v3, m, r0, 2 * k);
+            limb_sub_1(v3 + 2 * l, v3 + 2 * l, m - 2 * l, limb_submul_1(v3, r4, 2 * l, static_cast<W>(81)));
+            limb_divexact_1(v3, v3, m, static_cast<W>(3));
+
+            // r3 = (q3 + q1 - 2 * q2) / 2, r2 = q2 - q1 - 3 * r3, r1 = q1 - r2 - r3
+            limb_add_n(v3, v3, v1, m);
+            limb_submul_1(v3, v2, m, static_cast<W>(2));
+            limb_rshift(v3, v3, m, 1);
+
+            limb_sub_n(v2, v2, v1, m);
+            limb_submul_1(v2, v3, m, static_cast<W>(3));
+
+            limb_sub_n(v1, v1, v2, m);
+            limb_sub_n(v1, v1, v3, m);
+
+            // r += r1 * B^k + r2 * B^2k + r3 * B^3k, the coefficients fit in m limbs
+            for (auto [v, off] : {std::pair{v1, k}, std::pair{v2, 2 * k}, std::pair{v3, 3 * k}}) {
+                std::size_t len = std::min(m, 2 * n - off);
+                W carry = limb_add_n(r + off, r + off, v, len);
+                limb_add_1(r + off + len, r + off + len, 2 * n - off - len, carry);
+            }
+        }
+
+        // r[0, 2n) = a[0, n) * b[0, n), r must not alias a or b
+        // scratch must hold limb_mul_n_scratch_size(n, th) limbs
+        template<limb_word W>
+        constexpr void limb_mul_n(W* r, const W* a, const W* b, std::size_t n, W* scratch, const mul_thresholds& th) {
+            if (n == 0) {
+                return;
+            }
+            if (n < th.karatsuba || std::is_constant_evaluated()) {
+                limb_mul_basecase(r, a, n, b, n);
+            } else if (n >= th.ntt && ntt_fits<W>(n, n)) {
+                limb_mul_ntt(r, a, n, b, n);
+            } else if (n < th.toom3) {
+                limb_mul_karatsuba(r, a, b, n, scratch, th);
+            } else {
+                limb_mul_toom3(r, a, b, n, scratch, th);
+            }
+        }
+
+        // limbs of scratch needed by limb_mul for an x bn operands
+        constexpr std::size_t limb_mul_scratch_size(std::size_t an, std::size_t bn, const mul_thresholds& th = default_mul_thresholds) noexcept {
+            std::size_t n = std::min(an, bn);
+            if (n < th.karatsuba) {
+                return 0;
+            }
+            return 2 * n + limb_mul_n_scratch_size(n, th) + limb_mul_scratch_size(n, std::max(an, bn) % n, th);
+        }
+
+        // r[0, an + bn) = a[0, an) * b[0, bn), r must not alias a or b
+        // unbalanced operands are cut into pieces the size of the shorter one
+        template<limb_word W>
+        constexpr void limb_mul(W* r, const W* a, std::size_t an, const W* b, std::size_t bn, W* scratch, const mul_thresholds& th = default_mul_thresholds) {
+            if (an < bn) {
+                std::swap(a, b);
+                std::swap(an, bn);
+            }
+            if (bn == 0) {
+                std::fill(r, r + an, static_cast<W>(0));
+                return;
+            }
+            if (bn < th.karatsuba || std::is_constant_evaluated()) {
+                limb_mul_basecase(r, a, an, b, bn);
+                return;
+            }
+            if (bn >= th.ntt && ntt_fits<W>(an, bn)) {
+                limb_mul_ntt(r, a, an, b, bn);
+                return;
+            }
+            if (an == bn) {
+                limb_mul_n(r, a, b, an, scratch, th);
+                return;
+            }
+
+            W* piece = scratch;
+            W* next = piece + 2 * bn;
+            std::fill(r, r + an + bn, static_cast<W>(0));
+            for (std::size_t i = 0; i < an; i += bn) {
+                std::size_t len = std::min(bn, an - i);
+                if (len == bn) {
+                    limb_mul_n(piece, a + i, b, bn, next, th);
+                } else {
+                    limb_mul(piece, b, bn, a + i, len, next, th);
+                }
+                // nothing is written past the current piece yet, so the carry lands on a zero limb
+                W carry = limb_add_n(r + i, r + i, piece, len + bn);
+                if (i + len < an) {
+                    r[i + len + bn] = carry;
+                }
+            }
+        }
+
+        // limb_mul with its scratch taken from the thread local stack
+        template<limb_word W>
+        constexpr void limb_mul_alloc(W* r, const W* a, std::size_t an, const W* b, std::size_t bn, const mul_thresholds& th = default_mul_thresholds) {
+            limb_scratch<W> scratch(limb_mul_scratch_size(an, bn, th));
+            limb_mul(r, a, an, b, bn, scratch.data, th);
+        }
+    }
+}
@@ -0,0 +1,305 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "limb.h"
+
+// three-prime number theoretic transform multiplication
+// operands are cut into 32-bit chunks, convolved modulo three ntt primes and
+// recombined by CRT, the primes multiply to more than 2^88 so any product of
+// up to 2^23 chunks is exact
+
+namespace exlib {
+    namespace details {
+        // arithmetic modulo an ntt prime p < 2^30, values kept in montgomery form
+        struct ntt_prime {
+            std::uint32_t p;
+            std::uint32_t g;
+            std::uint32_t p_neg_inv;
+            std::uint32_t r2;
+
+            constexpr ntt_prime(std::uint32_t mod, std::uint32_t root) noexcept
+            : p(mod), g(root), p_neg_inv(0), r2(0) {
+                std::uint32_t inv = mod;
+                for (int i = 0; i < 4; ++i) {
+                    inv *= 2 - mod * inv;
+                }
+                p_neg_inv = 0u - inv;
+                r2 = static_cast<std::uint32_t>((~static_cast<std::uint64_t>(0) % mod + 1) % mod);
+            }
+
+            std::uint32_t reduce(std::uint64_t x) const noexcept {
+                std::uint32_t m = static_cast<std::uint32_t>(x) * p_neg_inv;
+                std::uint32_t t = static_cast<std::uint32_t>((x + static_cast<std::uint64_t>(m) * p) >> 32);
+                return t >= p ? t - p : t;
+            }
+
+            std::uint32_t mul(std::uint32_t a, std::uint32_t b) const noexcept {
+                return reduce(static_cast<std::uint64_t>(a) * b);
+            }
+
+            std::uint32_t add(std::uint32_t a, std::uint32_t b) const noexcept {
+                std::uint32_t s = a + b;
+                return s >= p ? s - p : s;
+            }
+
+            std::uint32_t sub(std::uint32_t a, std::uint32_t b) const noexcept {
+                return a >= b ? a - b : a + p - b;
+            }
+
+            // any 32-bit value into montgomery form
+            std::uint32_t to_mont(std::uint32_t a) const noexcept {
+                return mul(a, r2);
+            }
+
+            std::uint32_t from_mont(std::uint32_t a) const noexcept {
+                return reduce(a);
+            }
+
+            std::uint32_t pow(std::uint32_t base, std::uint64_t e) const noexcept {
+                std::uint32_t res = to_mont(1);
+                while (e) {
+                    if (e & 1) res = mul(res, base);
+                    base = mul(base, base);
+                    e >>= 1;
+                }
+                return res;
+            }
+        };
+
+        inline constexpr std::array<ntt_prime, 3> ntt_primes = {
+            ntt_prime(998244353, 3),
+            ntt_prime(469762049, 3),
+            ntt_prime(754974721, 11)
+        };
+
+        inline constexpr std::size_t ntt_max_length = std::size_t(1) << 23;
+
+        // twiddle factors of one prime, roots[h + j] = w_{2h}^j for every power of two h
+        // the table only grows, so all lengths up to the largest seen share it
+        struct ntt_plan {
+            std::vector<std::uint32_t> roots;
+            std::vector<std::uint32_t> iroots;
+
+            void reserve(const ntt_prime& pr, std::size_t length) {
+                if (length <= roots.size()) {
+                    return;
+                }
+                std::size_t h = roots.empty() ? 1 : roots.size();
+                roots.resize(length);
+                iroots.resize(length);
+                for (; h < length; h *= 2) {
+                    std::uint32_t w = pr.pow(pr.to_mont(pr.g), (pr.p - 1) / (2 * h));
+                    std::uint32_t iw = pr.pow(w, pr.p - 2);
+                    std::uint32_t x = pr.to_mont(1);
+                    std::uint32_t ix = x;
+                    for (std::size_t j = 0; j < h; ++j) {
+                        roots[h + j] = x;
+                        iroots[h + j] = ix;
+                        x = pr.mul(x, w);
+                        ix = pr.mul(ix, iw);
+                    }
+                }
+            }
+        };
+
+        // per-thread plans and transform buffers, reused across multiplications
+        struct ntt_workspace {
+            std::array<ntt_plan, 3> plans;
+            std::vector<std::uint32_t> fa;
+            std::vector<std::uint32_t> fb;
+            std::array<std::vector<std::uint32_t>, 3> residues;
+            std::vector<std::uint32_t> chunks;
+
+            static ntt_workspace& get() noexcept {
+                thread_local ntt_workspace ws;
+                return ws;
+            }
+        };
+
+        // decimation in frequency, natural order in, bit-reversed order out
+        inline void ntt_forward(std::uint32_t* a, std::size_t length, const ntt_prime& pr, const std::uint32_t* roots) noexcept {
+            for (std::size_t len = length; len >= 2; len /= 2) {
+                const std::size_t h = len / 2;
+                const std::uint32_t* w = roots + h;
+                for (std::size_t i = 0; i < length; i += len) {
+                    for (std::size_t j = 0; j < h; ++j) {
+                        std::uint32_t u = a[i + j];
+                        std::uint32_t v = a[i + j + h];
+                        a[i + j] = pr.add(u, v);
+                        a[i + j + h] = pr.mul(pr.sub(u, v), w[j]);
+                    }
+                }
+            }
+        }
+
+        // decimation in time with inverse roots, bit-reversed order in, natural order out
+        inline void ntt_inverse(std::uint32_t* a, std::size_t length, const ntt_prime& pr, const std::uint32_t* iroots) noexcept {
+            for (std::size_t len = 2; len <= length; len *= 2) {
+                const std::size_t h = len / 2;
+                const std::uint32_t* w = iroots + h;
+                for (std::size_t i = 0; i < length; i += len) {
+                    for (std::size_t j = 0; j < h; ++j) {
+                        std::uint32_t u = a[i + j];
+                        std::uint32_t v = pr.mul(a[i + j + h], w[j]);
+                        a[i + j] = pr.add(u, v);
+                        a[i + j + h] = pr.sub(u, v);
+                    }
+                }
+            }
+        }
+
+        template<limb_word W>
+        inline constexpr std::size_t ntt_chunks(std::size_t n) noexcept {
+            return (n * limb_bits<W> + 31) / 32;
+        }
+
+        // out[0, ntt_chunks(n)) = a[0, n) split into 32-bit chunks
+        template<limb_word W>
+        inline void ntt_load(std::uint32_t* out, const W* a, std::size_t n) noexcept {
+            const std::size_t chunks = ntt_chunks<W>(n);
+            if constexpr (limb_bits<W> >= 32) {
+                constexpr std::size_t per = limb_bits<W> / 32;
+                for (std::size_t i = 0; i < chunks; ++i) {
+                    out[i] = static_cast<std::uint32_t>(a[i / per] >> (32 * (i % per)));
+                }
+            } else {
+                constexpr std::size_t per = 32 / limb_bits<W>;
+                for (std::size_t i = 0; i < chunks; ++i) {
+                    std::uint32_t v = 0;
+                    for (std::size_t k = 0; k < per && i * per + k < n; ++k) {
+                        v |= static_cast<std::uint32_t>(a[i * per + k]) << (k * limb_bits<W>);
+                    }
+                    out[i] = v;
+                }
+            }
+        }
+
+        // r[0, n) = the 32-bit chunks in[...] packed back into limbs
+        template<limb_word W>
+        inline void ntt_store(W* r, std::size_t n, const std::uint32_t* in) noexcept {
+            if constexpr (limb_bits<W> >= 32) {
+                constexpr std::size_t per = limb_bits<W> / 32;
+                for (std::size_t i = 0; i < n; ++i) {
+                    W v = 0;
+                    for (std::size_t k = 0; k < per; ++k) {
+                        v |= static_cast<W>(static_cast<W>(in[i * per + k]) << (32 * k));
+                    }
+                    r[i] = v;
+                }
+            } else {
+                constexpr std::size_t per = 32 / limb_bits<W>;
+                for (std::size_t i = 0; i < n; ++i) {
+                    r[i] = static_cast<W>(in[i / per] >> ((i % per) * limb_bits<W>));
+                }
+            }
+        }
+
+        // whether limb_mul_ntt can handle an x bn operands exactly
+        template<limb_word W>
+        inline bool ntt_fits(std::size_t an, std::size_t bn) noexcept {
+            return ntt_chunks<W>(an) + ntt_chunks<W>(bn) <= ntt_max_length;
+        }
+
+        // r[0, an + bn) = a[0, an) * b[0, bn), r must not alias a or b
+        template<limb_word W>
+        void limb_mul_ntt(W* r, const W* a, std::size_t an, const W* b, std::size_t bn) {
+            auto& ws = ntt_workspace::get();
+            const bool square = (a == b && an == bn);
+            const std::size_t na = ntt_chunks<W>(an);
+            const std::size_t nb = ntt_chunks<W>(bn);
+            const std::size_t terms = na + nb - 1;
+            std::size_t length = 1;
+            while (length < terms) {
+                length *= 2;
+            }
+
+            ws.fa.resize(length);
+            ws.fb.resize(length);
+            ws.chunks.resize(na + nb);
+            for (std::size_t k = 0; k < 3; ++k) {
+                const ntt_prime& pr = ntt_primes[k];
+                ws.plans[k].reserve(pr, length);
+                const std::uint32_t* roots = ws.plans[k].roots.data();
+                std::uint32_t* fa = ws.fa.data();
+                std::uint32_t* fb = ws.fb.data();
+
+                ntt_load(ws.chunks.data(), a, an);
+                for (std::size_t i = 0; i < na; ++i) {
+                    fa[i] = pr.to_mont(ws.chunks[i]);
+                }
+                std::fill(fa + na, fa + length, 0u);
+                ntt_forward(fa, length, pr, roots);
+
+                if (square) {
+                    for (std::size_t i = 0; i < length; ++i) {
+                        fa[i] = pr.mul(fa[i], fa[i]);
+                    }
+                } else {
+                    ntt_load(ws.chunks.data(), b, bn);
+                    for (std::size_t i = 0; i < nb; ++i) {
+                        fb[i] = pr.to_mont(ws.chunks[i]);
+                    }
+                    std::fill(fb + nb, fb + length, 0u);
+                    ntt_forward(fb, length, pr, roots);
+                    for (std::size_t i = 0; i < length; ++i) {
+                        fa[i] = pr.mul(fa[i], fb[i]);
+                    }
+                }
+
+                ntt_inverse(fa, length, pr, ws.plans[k].iroots.data());
+                // scale by 1 / length and leave montgomery form in one multiplication
+                const std::uint32_t scale = pr.pow(pr.to_mont(static_cast<std::uint32_t>(length % pr.p)), pr.p - 2);
+                auto& res = ws.residues[k];
+                res.resize(terms);
+                for (std::size_t i = 0; i < terms; ++i) {
+                    res[i] = pr.from_mont(pr.mul(fa[i], scale));
+                }
+            }
+
+            // garner: x = v1 + m1 * v2 + m1 * m2 * v3
+            constexpr std::uint64_t m1 = ntt_primes[0].p;
+            constexpr std::uint64_t m2 = ntt_primes[1].p;
+            constexpr std::uint64_t m3 = ntt_primes[2].p;
+            constexpr std::uint64_t m12 = m1 * m2;
+            auto inv_mod = [](std::uint64_t x, std::uint64_t m) {
+                std::uint64_t res = 1, e = m - 2;
+                x %= m;
+                while (e) {
+                    if (e & 1) res = res * x % m;
+                    x = x * x % m;
+                    e >>= 1;
+                }
+                return res;
+            };
+            const std::uint64_t inv_m1 = inv_mod(m1, m2);
+            const std::uint64_t inv_m12 = inv_mod(m12 % m3, m3);
+
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i < terms; ++i) {
+                std::uint64_t v1 = ws.residues[0][i];
+                std::uint64_t v2 = (ws.residues[1][i] + m2 - v1 % m2) % m2 * inv_m1 % m2;
+                std::uint64_t low = v1 + m1 * v2;
+                std::uint64_t v3 = (ws.residues[2][i] + m3 - low % m3) % m3 * inv_m12 % m3;
+
+                std::uint64_t hi;
+                std::uint64_t lo = mul_wide<std::uint64_t>(m12, v3, hi);
+                std::uint64_t c = 0;
+                lo = add_with_carry<std::uint64_t>(lo, low, c);
+                hi += c;
+                c = 0;
+                lo = add_with_carry<std::uint64_t>(lo, carry, c);
+                hi += c;
+
+                ws.chunks[i] = static_cast<std::uint32_t>(lo);
+                carry = (lo >> 32) | (hi << 32);
+            }
+            ws.chunks[terms] = static_cast<std::uint32_t>(carry);
+
+            ntt_store(r, an + bn, ws.chunks.data());
+        }
+    }
+}
@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "limb.h"
+#include "limb_mul.h"
+#include "limb_div.h"
+
+// text conversion of limb arrays
+// power of two bases move whole digits in and out of limbs through lookup tables
+// decimal: small values peel off (or take in) the largest power of ten fitting in a limb per step,
+// large values are split recursively by cached powers 10^(chunk * 2^k)
+// thresholds are in limbs, override them before including integer.h
+
+#ifndef EXLIB_STR_DC_THRESHOLD
+#define EXLIB_STR_DC_THRESHOLD 32
+#endif
+
+namespace exlib {
+    namespace details {
+        inline constexpr std::size_t str_dc_threshold = EXLIB_STR_DC_THRESHOLD;
+
+        inline constexpr char limb_digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+        // value of a digit character in bases up to 36, 255 for anything else
+        inline constexpr std::array<unsigned char, 256> limb_digit_values = [] {
+            std::array<unsigned char, 256> res{};
+            res.fill(255);
+            for (unsigned char i = 0; i < 36; ++i) {
+                res[static_cast<unsigned char>(limb_digit_chars[i])] = i;
+                if (i >= 10) {
+                    res[static_cast<unsigned char>(limb_digit_chars[i] - 'a' + 'A')] = i;
+                }
+            }
+            return res;
+        }();
+
+        // number of base 2^bits digits of a[0, n), 0 for zero
+        template<limb_word W>
+        constexpr std::size_t limb_pow2_digits(const W* a, std::size_t n, std::size_t bits) noexcept {
+            n = limb_trim(a, n);
+            if (n == 0) {
+                return 0;
+            }
+            const std::size_t total = (n - 1) * limb_bits<W> + static_cast<std::size_t>(std::bit_width(a[n - 1]));
+            return (total + bits - 1) / bits;
+        }
+
+        // out[0, count) = the lowest count base 2^bits digits of a[0, n), most significant first
+        template<limb_word W>
+        constexpr void limb_to_pow2(char* out, std::size_t count, const W* a, std::size_t n, std::size_t bits) noexcept {
+            const W mask = static_cast<W>((static_cast<W>(1) << bits) - 1);
+            if (limb_bits<W> % bits == 0) {
+                // digits never straddle two limbs
+                char* p = out + count;
+                for (std::size_t i = 0; p > out; ++i) {
+                    W w = (i < n) ? a[i] : static_cast<W>(0);
+                    for (std::size_t k = 0; k < limb_bits<W> / bits && p > out; ++k) {
+                        *--p = limb_digit_chars[w & mask];
+                        w = static_cast<W>(w >> bits);
+                    }
+                }
+                return;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::size_t pos = i * bits;
+                const std::size_t j = pos / limb_bits<W>;
+                const std::size_t off = pos % limb_bits<W>;
+                W v = (j < n) ? static_cast<W>(a[j] >> off) : static_cast<W>(0);
+                if (off + bits > limb_bits<W> && j + 1 < n) {
+                    v |= static_cast<W>(a[j + 1] << (limb_bits<W> - off));
+                }
+                out[count - 1 - i] = limb_digit_chars[v & mask];
+            }
+        }
+
+        // r[0, n) = the base 2^bits digits s[0, len) modulo B^n, every digit must be valid
+        template<limb_word W>
+        constexpr void limb_from_pow2(W* r, std::size_t n, const char* s, std::size_t len, std::size_t bits) noexcept {
+            std::fill(r, r + n, static_cast<W>(0));
+            for (std::size_t i = 0; i < len; ++i) {
+                const std::size_t pos = i * bits;
+                const std::size_t j = pos / limb_bits<W>;
+                const std::size_t off = pos % limb_bits<W>;
+                if (j >= n) {
+                    break;
+                }
+                const W v = limb_digit_values[static_cast<unsigned char>(s[len - 1 - i])];
+                r[j] |= static_cast<W>(v << off);
+                if (off + bits > limb_bits<W> && j + 1 < n) {
+                    r[j + 1] |= static_cast<W>(v >> (limb_bits<W> - off));
+                }
+            }
+        }
+
+        // the largest power of ten in a limb and its number of digits
+        template<limb_word W>
+        inline constexpr std::pair<W, std::size_t> limb_decimal_chunk = [] {
+            std::pair<W, std::size_t> res{1, 0};
+            while (res.first <= std::numeric_limits<W>::max() / 10) {
+                res.first *= 10;
+                ++res.second;
+            }
+            return res;
+        }();
+
+        // powers[k] = 10^(chunk * 2^k), trimmed, grown on demand and kept per thread
+        template<limb_word W>
+        struct limb_pow10_cache {
+            std::vector<std::vector<W>> powers;
+
+            const std::vector<W>& get(std::size_t k) {
+                if (powers.empty()) {
+                    powers.push_back({limb_decimal_chunk<W>.first});
+                }
+                while (powers.size() <= k) {
+                    const std::vector<W>& p = powers.back();
+                    std::vector<W> sq(2 * p.size());
+                    limb_mul_alloc(sq.data(), p.data(), p.size(), p.data(), p.size());
+                    sq.resize(limb_trim(sq.data(), sq.size()));
+                    powers.push_back(std::move(sq));
+                }
+                return powers[k];
+            }
+
+            static limb_pow10_cache& instance() noexcept {
+                thread_local limb_pow10_cache cache;
+                return cache;
+            }
+        };
+
+        // out[0, width) = a[0, n) in decimal, zero padded, a is destroyed
+        template<limb_word W>
+        constexpr void limb_to_decimal_basecase(char* out, std::size_t width, W* a, std::size_t n) noexcept {
+            constexpr auto chunk = limb_decimal_chunk<W>;
+            char* p = out + width;
+            n = limb_trim(a, n);
+            while (n > 0 && p > out) {
+                W rem = limb_divrem_1(a, a, n, chunk.first);
+                n = limb_trim(a, n);
+                for (std::size_t i = 0; i < chunk.second && p > out; ++i) {
+                    *--p = static_cast<char>('0' + rem % 10);
+                    rem /= 10;
+                }
+            }
+            std::fill(out, p, '0');
+        }
+
+        // out[0, 2 * chunk * 2^k) = a[0, n) in decimal, zero padded, for a < 10^(2 * chunk * 2^k)
+        // a is destroyed
+        template<limb_word W>
+        constexpr void limb_to_decimal_dc(char* out, W* a, std::size_t n, std::size_t k) {
+            const std::size_t half = limb_decimal_chunk<W>.second << k;
+            n = limb_trim(a, n);
+            if (n < str_dc_threshold) {
+                limb_to_decimal_basecase(out, 2 * half, a, n);
+                return;
+            }
+
+            // a = q * 10^half + r, both halves below 10^half
+            const std::vector<W>& pow = limb_pow10_cache<W>::instance().get(k);
+            const std::size_t pn = pow.size();
+            if (n < pn) {
+                std::fill(out, out + half, '0');
+                limb_to_decimal_dc(out + half, a, n, k - 1);
+                return;
+            }
+            const std::size_t qn = n - pn + 1;
+            limb_scratch<W> scratch(qn + pn + limb_div_qr_scratch_size(n, pn));
+            W* q = scratch.data;
+            W* r = q + qn;
+            if (pn == 1) {
+                r[0] = limb_divrem_1(q, a, n, pow[0]);
+            } else {
+                limb_div_qr(q, r, a, n, pow.data(), pn, r + pn);
+            }
+            if (k == 0) {
+                limb_to_decimal_basecase(out, half, q, qn);
+                limb_to_decimal_basecase(out + half, half, r, pn);
+            } else {
+                limb_to_decimal_dc(out, q, qn, k - 1);
+                limb_to_decimal_dc(out + half, r, pn, k - 1);
+            }
+        }
+
+        // decimal digits of a[0, n) without leading zeros, a is destroyed
+        template<limb_word W>
+        constexpr std::string limb_to_decimal(W* a, std::size_t n) {
+            n = limb_trim(a, n);
+            if (n == 0) {
+                return "0";
+            }
+
+            std::string res;
+            if (n < str_dc_threshold || std::is_constant_evaluated()) {
+                // log10(2) rounded up
+                res.assign(n * limb_bits<W> * 30103 / 100000 + 1, '0');
+                limb_to_decimal_basecase(res.data(), res.size(), a, n);
+            } else {
+                // the smallest k with a < 10^(2 * chunk * 2^k)
+                auto& cache = limb_pow10_cache<W>::instance();
+                std::size_t k = 0;
+                while (2 * (cache.get(k).size() - 1) < n) {
+                    ++k;
+                }
+                res.assign(2 * (limb_decimal_chunk<W>.second << k), '0');
+                limb_to_decimal_dc(res.data(), a, n, k);
+            }
+            res.erase(0, std::min(res.find_first_not_of('0'), res.size() - 1));
+            return res;
+        }
+    
+        // limbs enough for any decimal of len digits, log2(10) rounded up
+        template<limb_word W>
+        inline constexpr std::size_t limb_decimal_limbs(std::size_t len) noexcept {
+            return len * 33220 / 10000 / limb_bits<W> + 1;
+        }
+
+        // r[0, n) = the decimal digits s[0, len) modulo B^n
+        template<limb_word W>
+        constexpr void limb_from_decimal_basecase(W* r, std::size_t n, const char* s, std::size_t len) noexcept {
+            constexpr auto chunk = limb_decimal_chunk<W>;
+            std::fill(r, r + n, static_cast<W>(0));
+            std::size_t rn = 0;
+            // the first group takes the digits left over by whole chunks
+            std::size_t group = len % chunk.second == 0 ? chunk.second : len % chunk.second;
+            for (std::size_t pos = 0; pos < len; pos += group, group = chunk.second) {
+                W v = 0;
+                W scale = 1;
+                for (std::size_t i = 0; i < group; ++i) {
+                    v = static_cast<W>(v * 10 + static_cast<W>(s[pos + i] - '0'));
+                    scale = static_cast<W>(scale * 10);
+                }
+                if (rn == 0) {
+                    r[0] = v;
+                    rn = v != 0;
+                    continue;
+                }
+                W top = limb_mul_1(r, r, rn, scale);
+                top = static_cast<W>(top + limb_add_1(r, r, rn, v));
+                if (top != 0 && rn < n) {
+                    r[rn++] = top;
+                }
+            }
+        }
+
+        // r[0, limb_decimal_limbs(len)) = the decimal digits s[0, len)
+        // the low half of the digits is split off by the largest cached power below len
+        template<limb_word W>
+        constexpr void limb_from_decimal_dc(W* r, const char* s, std::size_t len) {
+            const std::size_t rn = limb_decimal_limbs<W>(len);
+            if (rn < str_dc_threshold || len <= 2 * limb_decimal_chunk<W>.second) {
+                limb_from_decimal_basecase(r, rn, s, len);
+                return;
+            }
+
+            std::size_t k = 0;
+            while ((limb_decimal_chunk<W>.second << (k + 1)) < len) {
+                ++k;
+            }
+            const std::size_t half = limb_decimal_chunk<W>.second << k;
+            const std::vector<W>& pow = limb_pow10_cache<W>::instance().get(k);
+            const std::size_t pn = pow.size();
+            const std::size_t hn = limb_decimal_limbs<W>(len - half);
+            const std::size_t ln = limb_decimal_limbs<W>(half);
+            limb_scratch<W> scratch(hn + ln + pn + hn);
+            W* hi = scratch.data;
+            W* lo = hi + hn;
+            W* t = lo + ln;
+            limb_from_decimal_dc(hi, s, len - half);
+            limb_from_decimal_dc(lo, s + (len - half), half);
+
+            // r = hi * 10^half + lo
+            const std::size_t htn = limb_trim(hi, hn);
+            const std::size_t tn = pn + htn;
+            if (htn == 0) {
+                std::fill(t, t + pn, static_cast<W>(0));
+            } else if (htn > pn) {
+                limb_mul_alloc(t, hi, htn, pow.data(), pn);
+            } else {
+                limb_mul_alloc(t, pow.data(), pn, hi, htn);
+            }
+            limb_add(t, t, tn, lo, limb_trim(lo, ln));
+            const std::size_t m = std::min(limb_trim(t, tn), rn);
+            std::copy_n(t, m, r);
+            std::fill(r + m, r + rn, static_cast<W>(0));
+        }
+
+        // r[0, n) = the decimal digits s[0, len) modulo B^n
+        template<limb_word W>
+        constexpr void limb_from_decimal(W* r, std::size_t n, const char* s, std::size_t len) {
+            const std::size_t rn = limb_decimal_limbs<W>(len);
+            if (rn < str_dc_threshold || std::is_constant_evaluated()) {
+                limb_from_decimal_basecase(r, n, s, len);
+                return;
+            }
+            limb_scratch<W> scratch(rn);
+            limb_from_decimal_dc(scratch.data, s, len);
+            const std::size_t m = std::min(rn, n);
+            std::copy_n(scratch.data, m, r);
+            std::fill(r + m, r + n, static_cast<W>(0));
+        }
+    }
+}
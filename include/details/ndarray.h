@@ -133,8 +133,8 @@ namespace exlib {
     template <typename T>
     struct is_ndarray : std::false_type {};
 
-    template <typename Shape, class DType>
-    struct is_ndarray<ndarray<Shape, DType>> : std::true_type {};
+    template <typename Shape, class DType, class Allocator>
+    struct is_ndarray<ndarray<Shape, DType, Allocator>> : std::true_type {};
 
     template <typename T>
     inline constexpr bool is_ndarray_v = is_ndarray<std::decay_t<T>>::value;
@@ -162,9 +162,9 @@ namespace exlib {
         using reverse_iterator = typename array_type::reverse_iterator;
         using const_reverse_iterator = typename array_type::const_reverse_iterator;
         
-        using self_type = ndarray<Shape, DType>;
-        using reference = ndarray<Shape, DType>&;
-        using const_reference = const ndarray<Shape, DType>&;
+        using self_type = ndarray<Shape, DType, Allocator>;
+        using reference = self_type&;
+        using const_reference = const self_type&;
 
         array_type data;
 
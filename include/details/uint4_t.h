@@ -8,152 +8,152 @@ namespace exlib {
         struct uint4_t {
             std::uint8_t _data;
 
-            uint4_t() noexcept {
+            constexpr uint4_t() noexcept {
                 _data = 0;
             }
 
             template<typename I>
-            uint4_t(const I& i) noexcept {
+            constexpr uint4_t(const I& i) noexcept {
                 _data = static_cast<std::uint8_t>(i);
             }
 
-            uint4_t operator+(const uint4_t& other) const noexcept {
+            constexpr uint4_t operator+(const uint4_t& other) const noexcept {
                 uint4_t copy = *this;
                 copy += other;
                 return copy;
             }
 
-            uint4_t operator-(const uint4_t& other) const noexcept {
+            constexpr uint4_t operator-(const uint4_t& other) const noexcept {
                 uint4_t copy = *this;
                 copy -= other;
                 return copy;
             }
 
-            uint4_t& operator+=(const uint4_t& other) noexcept {
+            constexpr uint4_t& operator+=(const uint4_t& other) noexcept {
                 _data += other._data;
                 return *this;
             }
 
-            uint4_t& operator-=(const uint4_t& other) noexcept {
+            constexpr uint4_t& operator-=(const uint4_t& other) noexcept {
                 _data -= other._data;                
                 return *this;
             }
 
-            std::uint16_t value() const noexcept {
+            constexpr std::uint16_t value() const noexcept {
                 return _data & 0xf;
             }
 
-            uint4_t& operator*=(const uint4_t& other) noexcept {
+            constexpr uint4_t& operator*=(const uint4_t& other) noexcept {
                 _data *= other._data;
                 return *this;
             }
 
-            uint4_t operator*(const uint4_t& other) const noexcept {
+            constexpr uint4_t operator*(const uint4_t& other) const noexcept {
                 uint4_t copy = *this;
                 copy *= other;
                 return copy;
             }
 
-            uint4_t& operator<<=(std::size_t x) noexcept {
+            constexpr uint4_t& operator<<=(std::size_t x) noexcept {
                 _data <<= x;
                 return *this;
             }
 
-            uint4_t& operator>>=(std::size_t x) noexcept {
+            constexpr uint4_t& operator>>=(std::size_t x) noexcept {
                 _data >>= x;
                 return *this;
             }
 
-            uint4_t& operator/=(const uint4_t& other) {
+            constexpr uint4_t& operator/=(const uint4_t& other) {
                 _data /= other._data;
                 return *this;
             } 
 
-            uint4_t& operator%=(const uint4_t& other) {
+            constexpr uint4_t& operator%=(const uint4_t& other) {
                 _data %= other._data;
                 return *this;
             } 
 
             template<typename I>
-            bool operator==(const I& i) const noexcept {
+            constexpr bool operator==(const I& i) const noexcept {
                 return _data == static_cast<std::uint16_t>(i);
             }
 
             template<typename I>
-            bool operator!=(const I& i) const noexcept {
+            constexpr bool operator!=(const I& i) const noexcept {
                 return _data != static_cast<std::uint16_t>(i);
             }
 
-            bool operator==(const uint4_t& other) const noexcept {
+            constexpr bool operator==(const uint4_t& other) const noexcept {
                 return _data == other._data;
             }
 
-            bool operator!=(const uint4_t& other) const noexcept {
+            constexpr bool operator!=(const uint4_t& other) const noexcept {
                 return _data != other._data;
             }
 
-            bool operator>=(const uint4_t& other) const noexcept {
+            constexpr bool operator>=(const uint4_t& other) const noexcept {
                 return _data >= other._data;
             }
 
-            bool operator<=(const uint4_t& other) const noexcept {
+            constexpr bool operator<=(const uint4_t& other) const noexcept {
                 return _data <= other._data;
             }
 
-            bool operator>(const uint4_t& other) const noexcept {
+            constexpr bool operator>(const uint4_t& other) const noexcept {
                 return _data > other._data;
             }
 
-            bool operator<(const uint4_t& other) const noexcept {
+            constexpr bool operator<(const uint4_t& other) const noexcept {
                 return _data < other._data;
             }
 
-            uint4_t operator/(const uint4_t& other) noexcept {
+            constexpr uint4_t operator/(const uint4_t& other) noexcept {
                 uint4_t copy = *this;
                 copy /= other;
                 return copy;
             }
 
-            uint4_t& operator&=(const uint4_t& other) noexcept {
+            constexpr uint4_t& operator&=(const uint4_t& other) noexcept {
                 _data &= other._data;
                 return *this;
             }
 
-            uint4_t operator&(const uint4_t& other) const noexcept {
+            constexpr uint4_t operator&(const uint4_t& other) const noexcept {
                 uint4_t copy = *this;
                 copy &= other;
                 return copy;
             }
 
-            uint4_t& operator|=(const uint4_t& other) noexcept {
+            constexpr uint4_t& operator|=(const uint4_t& other) noexcept {
                 _data |= other._data;
                 return *this;
             }
 
-            uint4_t operator|(const uint4_t& other) const noexcept {
+            constexpr uint4_t operator|(const uint4_t& other) const noexcept {
                 uint4_t copy = *this;
                 copy |= other;
                 return copy;
             }
 
-            uint4_t& operator^=(const uint4_t& other) noexcept {
+            constexpr uint4_t& operator^=(const uint4_t& other) noexcept {
                 _data ^= other._data;
                 return *this;
             }
 
-            uint4_t operator^(const uint4_t& other) const noexcept {
+            constexpr uint4_t operator^(const uint4_t& other) const noexcept {
                 uint4_t copy = *this;
                 copy ^= other;
                 return copy;
             }
 
-            uint4_t operator&(int i) {
+            constexpr uint4_t operator&(int i) {
                 uint4_t copy = *this;
                 copy._data &= static_cast<std::uint8_t>(i);
                 return copy;
             }
 
-            uint4_t operator&(unsigned int i) {
+            constexpr uint4_t operator&(unsigned int i) {
                 uint4_t copy = *this;
                 copy._data &= static_cast<std::uint8_t>(i);
                 return copy;
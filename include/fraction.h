@@ -83,7 +83,8 @@ namespace exlib {
         }
 
         void shrink() noexcept {
-            auto g = std::gcd(a, b);
+            using std::gcd;
+            auto g = gcd(a, b);
             a /= g;
             b /= g;
         }
@@ -1,18 +1,36 @@
 #pragma once
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <bitset>
+#include <cctype>
+#include <charconv>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <climits>
 
 #include "details/uint4_t.h"
 #include "details/array_type.h"
+#include "details/limb.h"
+#include "details/limb_mul.h"
+#include "details/limb_div.h"
+#include "details/limb_gcd.h"
+#include "details/limb_str.h"
+#include "details/limb_bytes.h"
 
 #define byte_size CHAR_BIT
 
@@ -21,10 +39,10 @@ namespace exlib {
     template<std::size_t N, class Word, class Allocator, bool Signed>
     struct integer;
 
-    template<std::size_t N, class Word = unsigned int, class Allocator = std::allocator<Word>>
+    template<std::size_t N, class Word = unsigned int, class Allocator = details::default_allocator<N, Word>>
     using nints = integer<N, Word, Allocator, true>;
     
-    template<std::size_t N, class Word = unsigned int, class Allocator = std::allocator<Word>>
+    template<std::size_t N, class Word = unsigned int, class Allocator = details::default_allocator<N, Word>>
     using unints = integer<N, Word, Allocator, false>;
 
     // type traits
@@ -36,6 +54,25 @@ namespace exlib {
 
     template<typename T>
     inline constexpr bool is_integer_v = is_integer<std::decay_t<T>>::value;
+
+    namespace details {
+        // bits of a builtin or exlib integer type
+        template<typename I>
+        inline constexpr std::size_t int_bits_v = sizeof(I) * CHAR_BIT;
+
+        template<std::size_t N, class Word, class Allocator, bool Signed>
+        inline constexpr std::size_t int_bits_v<integer<N, Word, Allocator, Signed>> = N;
+
+        // std::signbit for builtin integers, usable in constant expressions
+        template<typename I>
+        constexpr bool int_signbit(I x) noexcept {
+            if constexpr (std::is_signed_v<I>) {
+                return x < 0;
+            } else {
+                return false;
+            }
+        }
+    }
 }
 
 namespace exlib {
@@ -45,6 +82,7 @@ namespace exlib {
 
         struct iterator;
         struct const_iterator;
+        struct set_bit_iterator;
         struct bit_reference;
         struct bit_const_reference;
         friend struct bit_reference;
@@ -52,6 +90,7 @@ namespace exlib {
         using reference = self_type&;
         using const_reference = const self_type&;
         using word_type = Word;
+        using allocator_type = Allocator;
         using bit = bool;
 
         inline static constexpr bool is_signed_v = Signed;
@@ -60,99 +99,148 @@ namespace exlib {
         inline static constexpr std::size_t digits = N;
         inline static constexpr std::size_t digits10 = std::floor(std::log10(2) * N) + 1;
 
-        using array_type = std::conditional_t<std::is_void_v<Allocator>, details::static_array<word_type, array_size>, details::dynamic_array<word_type, N, Allocator>>;
+        using array_type = std::conditional_t<std::is_void_v<Allocator>, details::static_array<word_type, array_size>, details::dynamic_array<word_type, array_size, Allocator>>;
+
+        // single-bit masks are built in the word's own width so 64-bit words work
+        using _mask_type = typename std::conditional_t<std::is_integral_v<word_type>, std::make_unsigned<word_type>, std::type_identity<unsigned int>>::type;
+
+        // operands whose limbs can be processed a whole word at a time
+        template<typename T>
+        inline static constexpr bool _is_limb_compatible = details::is_limb_v<word_type> && std::is_same_v<word_type, typename std::decay_t<T>::word_type>;
+
+        // operands with limbs of a different width, repacked a word at a time
+        template<typename T>
+        inline static constexpr bool _is_limb_repackable = details::is_limb_v<word_type> && details::is_limb_v<typename std::decay_t<T>::word_type>;
 
         array_type _data;
 
-        integer() noexcept {
+        constexpr integer() noexcept {
             _data.fill(0);
         }
 
-        integer(const_reference other) noexcept {
+        constexpr integer(const_reference other) noexcept {
             assign(other);
         }
 
-        integer(self_type&& other) noexcept {
+        constexpr integer(self_type&& other) noexcept {
             assign(std::move(other));
         }
 
         template <typename I>
         requires is_integer_v<I>
-        integer(const I& other) noexcept {
+        constexpr integer(const I& other) noexcept {
             assign(other);
         }
 
         template<typename I>
         requires std::is_integral_v<I> && (!is_integer_v<I>)
-        integer(const I& i) noexcept {
+        constexpr integer(const I& i) noexcept {
             assign(i);
         }
 
-        integer(const std::string& str) noexcept {
+        constexpr integer(std::string_view str) noexcept {
             rd_string(str);
         }
 
+        // expressions from integer_expr.h write their result straight into this
+        template<typename E>
+        requires requires(const E& e, self_type& r) { e._evaluate_into(r); }
+        constexpr integer(const E& e) {
+            e._evaluate_into(*this);
+        }
+
+        template<typename E>
+        requires requires(const E& e, self_type& r) { e._evaluate_into(r); }
+        constexpr reference operator=(const E& e) {
+            e._evaluate_into(*this);
+            return *this;
+        }
+
         template<typename I>
         requires std::is_integral_v<I> && (!is_integer_v<I>)
-        reference operator=(const I& i) noexcept {
+        constexpr reference operator=(const I& i) noexcept {
             return assign(i);
         }
  
         template <typename T>
         requires is_integer_v<T>
-        reference operator=(const T& other) noexcept {
+        constexpr reference operator=(const T& other) noexcept {
             return assign(other);
         }
 
-        reference operator=(const_reference other) noexcept {
+        constexpr reference operator=(const_reference other) noexcept {
             return assign(other);
         }
 
-        reference operator=(self_type&& other) noexcept {
+        constexpr reference operator=(self_type&& other) noexcept {
             return assign(std::move(other));
         }
 
         template <typename T>
         requires is_integer_v<T>
-        reference assign(const T& other) noexcept {
-            this->fill(other.filling_mask());
-            for (std::size_t i = 0; i < other.size() && i < N; ++i) {
-                this->_at(i) = other._at(i);
+        constexpr reference assign(const T& other) noexcept {
+            if constexpr (_is_limb_compatible<T>) {
+                constexpr std::size_t m = std::min(array_size, std::decay_t<T>::array_size);
+                std::copy_n(other._data.begin(), m, _data.begin());
+                std::fill(_data.begin() + m, _data.begin() + array_size, static_cast<word_type>(other.filling_mask()));
+                _normalize();
+            } else if constexpr (_is_limb_repackable<T>) {
+                for (std::size_t i = 0; i < array_size; ++i) {
+                    _data[i] = other.template _repack_word<word_type>(i);
+                }
+                _normalize();
+            } else {
+                this->fill(other.filling_mask());
+                for (std::size_t i = 0; i < other.size() && i < N; ++i) {
+                    this->_at(i) = other._at(i);
+                }
             }
             return *this;
         }
 
-        reference assign(self_type&& other) noexcept {
+        constexpr reference assign(self_type&& other) noexcept {
             if (&other != this) {
                 std::move(other._data.begin(), other._data.end(), _data.begin());
             }
             return *this;
         }
 
-        reference assign(const_reference other) noexcept {
+        constexpr reference assign(const_reference other) noexcept {
             std::copy(other._data.cbegin(), other._data.cend(), this->_data.begin());
             return *this;
         }
 
         template<typename I>
         requires std::is_integral_v<I> && (!is_integer_v<I>)
-        reference assign(const I& i) noexcept {
+        constexpr reference assign(const I& i) noexcept {
             using type = std::conditional_t<Signed, std::make_signed_t<I>, std::make_unsigned_t<I>>;
             type x = static_cast<type>(i);
             constexpr std::size_t M = sizeof(x) * byte_size;
-            const bit x_sign = std::signbit(x);
-            this->fill(x_sign);
-            for (std::size_t j = 0; j < N && j < M; ++j) {
-                this->_at(j) = (x >> j & 1);
+            const bit x_sign = details::int_signbit(x);
+            if constexpr (details::is_limb_v<word_type>) {
+                for (std::size_t j = 0; j < array_size; ++j) {
+                    _data[j] = (j * word_size < M) ? static_cast<word_type>(x >> (j * word_size)) : static_cast<word_type>(x_sign ? -1 : 0);
+                }
+                _normalize();
+            } else {
+                this->fill(x_sign);
+                for (std::size_t j = 0; j < N && j < M; ++j) {
+                    this->_at(j) = (x >> j & 1);
+                }
             }
             return *this;
         }
 
         template <typename T>
         requires is_integer_v<T>
-        auto operator*(const T& other) const noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();
+        constexpr auto operator*(const T& other) const noexcept {
+            constexpr std::size_t M = std::decay_t<T>::size();
             using result_type = integer<std::max(N, M), Word, Allocator, Signed>;
+            if constexpr (_is_limb_compatible<T>) {
+                result_type res;
+                res._limb_mul(*this, other);
+                return res;
+            }
             
             auto&& lhs_abs = result_type(this->abs());
             auto&& rhs_abs = other.abs();
@@ -171,26 +259,31 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I> 
-        auto operator*(const I& val) const noexcept {
-            using type = integer<sizeof(I) * byte_size, Word, Allocator, Signed>;
+        constexpr auto operator*(const I& val) const noexcept {
+            using type = integer<sizeof(I) * byte_size, Word, void, Signed>;
             return *this * type(val);
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend auto operator*(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr auto operator*(const I& lhs, const_reference rhs) noexcept {
             using type = integer<sizeof(I) * byte_size, Word, Allocator, Signed>;
             return type(lhs) * rhs;
         }
 
         template <typename T>
         requires is_integer_v<T>
-        auto operator/(const T& other) const {
+        constexpr auto operator/(const T& other) const {
             if (other == 0) {
                 throw std::runtime_error("divided by zero!");
             }
-            static constexpr std::size_t M = std::decay_t<T>::size();
+            constexpr std::size_t M = std::decay_t<T>::size();
             using result_type = integer<std::max(N, M), Word, Allocator, Signed>;
+            if constexpr (_is_limb_compatible<T>) {
+                result_type quotient;
+                _limb_divmod<result_type, result_type>(*this, other, &quotient, nullptr);
+                return quotient;
+            }
 
             auto&& lhs_abs = this->abs();
             auto&& rhs_abs = other.abs();
@@ -217,25 +310,30 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        auto operator/(const I& val) const {
+        constexpr auto operator/(const I& val) const {
             using type = integer<std::max(N, sizeof(I) * byte_size), Word, Allocator, Signed>;
             return *this / std::move(type(val));
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend auto operator/(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr auto operator/(const I& lhs, const_reference rhs) noexcept {
             using type = integer<std::max(sizeof(I) * byte_size, N), Word, Allocator, Signed>;
             return type(lhs) / rhs;
         }
 
         template <typename T>
         requires is_integer_v<T>
-        auto operator%(const T& other) const {
+        constexpr auto operator%(const T& other) const {
             if (other == 0) {
                 throw std::runtime_error("divided by zero!");
             }
             using result_type = integer<std::max(N, std::decay_t<T>::size()), Word, Allocator, Signed>;
+            if constexpr (_is_limb_compatible<T>) {
+                result_type remainder;
+                _limb_divmod<result_type, result_type>(*this, other, nullptr, &remainder);
+                return remainder;
+            }
 
             auto lhs_abs = this->abs();
             T rhs_abs = other.abs();
@@ -260,25 +358,31 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        auto operator%(const I& val) const {
+        constexpr auto operator%(const I& val) const {
             using type = integer<std::max(N, sizeof(I) * byte_size), Word, Allocator, Signed>;
             return *this % type(val);
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend auto operator%(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr auto operator%(const I& lhs, const_reference rhs) noexcept {
             using result_type = integer<std::max(sizeof(I) * byte_size, N), Word, Allocator, Signed>;
             return result_type(lhs) % rhs;
         }
 
         template <typename T>
         requires is_integer_v<T>
-        reference operator*=(const T& other) noexcept {
+        constexpr reference operator*=(const T& other) noexcept {
+            if constexpr (_is_limb_compatible<T>) {
+                self_type result;
+                result._limb_mul(*this, other);
+                this->swap(result);
+                return *this;
+            }
             auto lhs_abs = this->abs();
             auto rhs_abs = other.abs();
 
-            static constexpr std::size_t M = std::decay_t<T>::size();
+            constexpr std::size_t M = std::decay_t<T>::size();
             
             self_type result = 0;
             for (std::size_t i = 0; i < M; ++i) {
@@ -296,18 +400,22 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        reference operator*=(const I& val) noexcept {
-            *this *= integer<sizeof(I) * byte_size, Word, Allocator, Signed>(val);
+        constexpr reference operator*=(const I& val) noexcept {
+            *this *= integer<sizeof(I) * byte_size, Word, void, Signed>(val);
             return *this;
         }
 
         template <typename T>
         requires is_integer_v<T>
-        reference operator/=(const T& other) {
+        constexpr reference operator/=(const T& other) {
             if (other == 0) {
                 throw std::runtime_error("divided by zero!");
             }
-            static constexpr std::size_t M = std::decay_t<T>::size();
+            if constexpr (_is_limb_compatible<T>) {
+                _limb_divmod<self_type, self_type>(*this, other, this, nullptr);
+                return *this;
+            }
+            constexpr std::size_t M = std::decay_t<T>::size();
             auto lhs_abs = this->abs();
             T rhs_abs = other.abs();
 
@@ -334,17 +442,21 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        reference operator/=(const I& val) {
+        constexpr reference operator/=(const I& val) {
             *this /= integer<sizeof(I) * byte_size, Word, Allocator, Signed>(val);
             return *this;
         }
 
         template <typename T>
         requires is_integer_v<T>
-        reference operator%=(const T& other) {
+        constexpr reference operator%=(const T& other) {
             if (other == 0) {
                 throw std::runtime_error("divided by zero!");
             }
+            if constexpr (_is_limb_compatible<T>) {
+                _limb_divmod<self_type, self_type>(*this, other, nullptr, this);
+                return *this;
+            }
 
             auto lhs_abs = this->abs();
             T rhs_abs = other.abs();
@@ -370,15 +482,66 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        reference operator%=(const I& val) {
+        constexpr reference operator%=(const I& val) {
             *this %= integer<sizeof(I) * byte_size, Word, Allocator, Signed>(val);
             return *this;
         }
 
+        // quotient and remainder from a single division, same semantics as / and %
+        template <typename T>
+        requires is_integer_v<T>
+        constexpr auto divmod(const T& other) const {
+            if (other == 0) {
+                throw std::runtime_error("divided by zero!");
+            }
+            using result_type = integer<std::max(N, std::decay_t<T>::size()), Word, Allocator, Signed>;
+            std::pair<result_type, result_type> res;
+            if constexpr (_is_limb_compatible<T>) {
+                _limb_divmod(*this, other, &res.first, &res.second);
+            } else {
+                res.first = *this / other;
+                res.second = *this % other;
+            }
+            return res;
+        }
+
+        template<typename I>
+        requires std::is_integral_v<I>
+        constexpr auto divmod(const I& val) const {
+            using type = integer<std::max(N, sizeof(I) * byte_size), Word, Allocator, Signed>;
+            return divmod(type(val));
+        }
+
+        // divides in place by a single word, truncating toward zero
+        // returns the remainder of |this| / d
+        constexpr word_type div_small(word_type d) requires details::is_limb_v<word_type> {
+            if (d == 0) {
+                throw std::runtime_error("divided by zero!");
+            }
+            const bit neg = sign();
+            word_type* r = _data.data();
+            if (neg) {
+                details::limb_neg(r, r, array_size);
+            }
+            std::size_t n = array_size;
+            while (n > 0 && r[n - 1] == 0) {
+                --n;
+            }
+            word_type rem = details::limb_divrem_1(r, r, n, d);
+            if (neg) {
+                details::limb_neg(r, r, array_size);
+            }
+            _normalize();
+            return rem;
+        }
+
         template <typename T> 
         requires is_integer_v<T>
-        bit bitwise_add_assign(const T& other) noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr bit bitwise_add_assign(const T& other) noexcept {
+            if constexpr (_is_limb_compatible<T>) {
+                return _limb_add_assign(other);
+            }
+            constexpr std::size_t M = std::decay_t<T>::size();    
             bit carry = 0;
             for (std::size_t i = 0; i < N; ++i) {
                 bit lbit = (i < N) ? this->_at(i) : this->sign();
@@ -392,9 +555,17 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        bit bitwise_sub_assign(const T& other) noexcept {
+        constexpr bit bitwise_sub_assign(const T& other) noexcept {
             // 使用位宽扩展，溢出时不作处理
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+            constexpr std::size_t M = std::decay_t<T>::size();    
+            if constexpr (_is_limb_compatible<T> && M > N) {
+                integer<M, Word, void, Signed> wide = *this;
+                bit borrow = wide._limb_sub_assign(other);
+                *this = wide;
+                return borrow;
+            } else if constexpr (_is_limb_compatible<T>) {
+                return _limb_sub_assign(other);
+            }
             bit borrow = 0;
             
             for (std::size_t i = 0; i < std::max(N, M); ++i) {
@@ -411,7 +582,7 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T> && std::is_same_v<word_type, typename T::word_type>
-        bool _bitwise_equal(const T& other) const noexcept {
+        constexpr bool _bitwise_equal(const T& other) const noexcept {
             for (std::size_t i = 0; i < std::max(array_size, other.array_size); ++i) {
                 Word lword = (i < array_size) ? _data[i] : this->filling_mask();
                 Word rword = (i < other.array_size) ? other._data[i] : other.filling_mask();
@@ -424,8 +595,11 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T> && (!std::is_same_v<word_type, typename T::word_type>)
-        bool _bitwise_equal(const T& other) const noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr bool _bitwise_equal(const T& other) const noexcept {
+            if constexpr (_is_limb_repackable<T>) {
+                return _limb_compare(other) == 0;
+            }
+            constexpr std::size_t M = std::decay_t<T>::size();    
             for (std::size_t i = 0; i < std::max(N, M); ++i) {
                 bit lbit = (i < N) ? this->_at(i) : this->sign();
                 bit rbit = (i < M) ? other._at(i) : other.sign();
@@ -438,15 +612,15 @@ namespace exlib {
 
         template <typename T>
         requires is_integer_v<T>
-        auto operator&(const T& other) const noexcept {
+        constexpr auto operator&(const T& other) const noexcept {
             using type = integer<std::max(N, std::decay_t<T>::size()), Word, Allocator, Signed>;
             type res = *this;
-            return res._bitwise_ops(other, [](auto& l, auto& r){ return l & r; });
+            return res._bitwise_ops(other, [](const auto& l, const auto& r){ return l & r; });
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        auto operator&(const I& i) const noexcept {
+        constexpr auto operator&(const I& i) const noexcept {
             using type = integer<std::max(N, sizeof(I) * byte_size), Word, Allocator, Signed>;
             type res = *this;
             return res._bitwise_ops(integer<sizeof(I) * byte_size, Word, Allocator, Signed>(i), [](const auto& l, const auto& r){ return l & r; });
@@ -454,14 +628,14 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        reference operator&=(const T& other) noexcept {
+        constexpr reference operator&=(const T& other) noexcept {
             this->_bitwise_ops_assign(other, [](auto &l, const auto& r){ l &= r; });
             return *this;
         }
 
         template <typename T> 
         requires is_integer_v<T>
-        auto operator|(const T& other) const noexcept {
+        constexpr auto operator|(const T& other) const noexcept {
             using type = integer<std::max(N, std::decay_t<T>::size()), Word, Allocator, Signed>;
             type res = *this;
             return res._bitwise_ops(other, [](const auto& l, const auto& r){ return l | r; });
@@ -469,7 +643,7 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        auto operator|(const I& i) const noexcept {
+        constexpr auto operator|(const I& i) const noexcept {
             using type = integer<std::max(N, sizeof(I) * byte_size), Word, Allocator, Signed>;
             type res = *this;
             return res._bitwise_ops(integer<sizeof(I) * byte_size, Word, Allocator, Signed>(i), [](const auto& l, const auto& r){ return l | r; });
@@ -477,13 +651,13 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        reference operator|=(const T& other) noexcept {
+        constexpr reference operator|=(const T& other) noexcept {
             return _bitwise_ops_assign(other, [](auto& l, const auto& r){ l |= r;});
         }
 
         template <typename T> 
         requires is_integer_v<T>
-        auto operator^(const T& other) const noexcept {
+        constexpr auto operator^(const T& other) const noexcept {
             using type = integer<std::max(N, std::decay_t<T>::size()), Word, Allocator, Signed>;
             type res = *this;
             return res._bitwise_ops(other, [](const auto&l, const auto& r){ return l ^ r; });
@@ -491,20 +665,20 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        auto operator^(const I& i) const noexcept {
+        constexpr auto operator^(const I& i) const noexcept {
             using type = integer<std::max(N, sizeof(I) * byte_size), Word, Allocator, Signed>;
             type res = *this;
             return res._bitwise_ops(integer<sizeof(I) * byte_size, Word, Allocator, Signed>(i), [](const auto& l, const auto& r) { return l ^ r; });
         }
 
         template <typename T> requires is_integer_v<T>
-        reference operator^=(const T& other) noexcept {
+        constexpr reference operator^=(const T& other) noexcept {
             return _bitwise_ops_assign(other, [](auto& l, const auto& r) { l ^= r; });
         }
         
         template <typename T, class Func>
         requires is_integer_v<T> && std::is_same_v<word_type, typename T::word_type>
-        auto _bitwise_ops(const T& other, Func op) const noexcept {
+        constexpr auto _bitwise_ops(const T& other, Func op) const noexcept {
             using result_type = integer<std::max(N, std::decay_t<T>::size()), Word, Allocator, Signed>;
             result_type res;
             for (std::size_t i = 0; i < std::max(array_size, other.array_size); ++i) {
@@ -517,9 +691,15 @@ namespace exlib {
 
         template <typename T, class Func>
         requires is_integer_v<T> && (!std::is_same_v<word_type, typename T::word_type>)
-        auto _bitwise_ops(const T& other, Func op) const noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr auto _bitwise_ops(const T& other, Func op) const noexcept {
+            constexpr std::size_t M = std::decay_t<T>::size();    
             integer<std::max(N, M), Word, Allocator, Signed> res;
+            if constexpr (_is_limb_repackable<T>) {
+                for (std::size_t i = 0; i < res.array_size; ++i) {
+                    res._data[i] = static_cast<word_type>(op(this->_repack_word<word_type>(i), other.template _repack_word<word_type>(i)));
+                }
+                return res;
+            }
             for (std::size_t i = 0; i < std::max(N, M); ++i) {
                 bit lbit = ((i < N) ? this->_at(i) : this->sign());
                 bit rbit = ((i < M) ? other._at(i) : other.sign());
@@ -530,7 +710,7 @@ namespace exlib {
 
         template<typename T, class Func>
         requires is_integer_v<T> && std::is_same_v<word_type, typename T::word_type>
-        reference _bitwise_ops_assign(const T& other, Func op) noexcept {
+        constexpr reference _bitwise_ops_assign(const T& other, Func op) noexcept {
             for (std::size_t i = 0; i < array_size; ++i) {
                 word_type rword = ((i < other.array_size) ? other._data[i] : other.filling_mask());
                 op(_data[i], rword);
@@ -540,8 +720,15 @@ namespace exlib {
 
         template <typename T, class Func>
         requires is_integer_v<T> && (!std::is_same_v<word_type, typename T::word_type>)
-        reference _bitwise_ops_assign(const T& other, Func op) noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr reference _bitwise_ops_assign(const T& other, Func op) noexcept {
+            if constexpr (_is_limb_repackable<T>) {
+                for (std::size_t i = 0; i < array_size; ++i) {
+                    op(_data[i], other.template _repack_word<word_type>(i));
+                }
+                _normalize();
+                return *this;
+            }
+            constexpr std::size_t M = std::decay_t<T>::size();    
             for (std::size_t i = 0; i < N; ++i) {
                 auto rbit = ((i < M) ? other._at(i) : other.sign());
                 auto lbit = this->_at(i);
@@ -552,8 +739,12 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        reference operator+=(const T& other) noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr reference operator+=(const T& other) noexcept {
+            if constexpr (_is_limb_compatible<T>) {
+                _limb_add_assign(other);
+                return *this;
+            }
+            constexpr std::size_t M = std::decay_t<T>::size();    
             return _bitwise_add_assign<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&other](std::size_t i) { return (i < M) ? other[i] : other.sign(); });
@@ -561,10 +752,14 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        reference operator+=(const I& x) noexcept {
+        constexpr reference operator+=(const I& x) noexcept {
             constexpr std::size_t M = sizeof(I) * byte_size;
+            if constexpr (details::is_limb_v<word_type>) {
+                _limb_add_assign(integer<M, Word, void, Signed>(x));
+                return *this;
+            }
             auto val = static_cast<std::conditional_t<Signed, std::make_signed_t<I>, std::make_unsigned_t<I>>>(x);
-            const bool val_sign = std::signbit(val);
+            const bool val_sign = details::int_signbit(val);
             return _bitwise_add_assign<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&val, &val_sign](std::size_t i) { return (i < M) ? (val >> i & 1) : val_sign; });
@@ -572,8 +767,12 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        reference operator-=(const T& other) noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr reference operator-=(const T& other) noexcept {
+            if constexpr (_is_limb_compatible<T>) {
+                _limb_sub_assign(other);
+                return *this;
+            }
+            constexpr std::size_t M = std::decay_t<T>::size();    
             return _bitwise_sub_assign<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&other](std::size_t i) { return (i < M) ? other[i] : other.sign(); });
@@ -581,10 +780,14 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        reference operator-=(const I& x) noexcept {
+        constexpr reference operator-=(const I& x) noexcept {
             constexpr std::size_t M = sizeof(I) * byte_size;
+            if constexpr (details::is_limb_v<word_type>) {
+                _limb_sub_assign(integer<M, Word, void, Signed>(x));
+                return *this;
+            }
             auto val = static_cast<std::conditional_t<Signed, std::make_signed_t<I>, std::make_unsigned_t<I>>>(x);
-            const bool val_sign = std::signbit(val);
+            const bool val_sign = details::int_signbit(val);
             return _bitwise_sub_assign<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&val, &val_sign](std::size_t i) { return (i < M) ? (val >> i & 1) : val_sign; });
@@ -592,8 +795,13 @@ namespace exlib {
 
         template <typename T>
         requires is_integer_v<T>
-        auto operator+(const T& other) const noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr auto operator+(const T& other) const noexcept {
+            constexpr std::size_t M = std::decay_t<T>::size();    
+            if constexpr (_is_limb_compatible<T>) {
+                integer<std::max(N, M), Word, Allocator, Signed> res = *this;
+                res._limb_add_assign(other);
+                return res;
+            }
             return this->_bitwise_add<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&other](std::size_t i) { return (i < M) ? other[i] : other.sign(); });
@@ -601,9 +809,14 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        auto operator+(const I& val) const noexcept {
+        constexpr auto operator+(const I& val) const noexcept {
             constexpr std::size_t M = sizeof(I) * byte_size;
-            const bool val_sign = std::is_signed_v<I> ? std::signbit(val) : 0;
+            if constexpr (details::is_limb_v<word_type>) {
+                integer<std::max(N, M), Word, Allocator, Signed> res = *this;
+                res._limb_add_assign(integer<M, Word, void, std::is_signed_v<I>>(val));
+                return res;
+            }
+            const bool val_sign = details::int_signbit(val);
             return _bitwise_add<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&val, &val_sign](std::size_t i) { return (i < M) ? (val >> i & 1) : val_sign; });
@@ -611,9 +824,14 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend auto operator+(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr auto operator+(const I& lhs, const_reference rhs) noexcept {
             constexpr std::size_t M = sizeof(I) * byte_size;
-            const bool lhs_sign = std::is_signed_v<I> ? std::signbit(lhs) : 0;
+            if constexpr (details::is_limb_v<word_type>) {
+                integer<std::max(N, M), Word, Allocator, Signed> res = integer<M, Word, void, std::is_signed_v<I>>(lhs);
+                res._limb_add_assign(rhs);
+                return res;
+            }
+            const bool lhs_sign = details::int_signbit(lhs);
             return _bitwise_add<M>(
             [&lhs, &lhs_sign](std::size_t i) { return (i < M) ? (lhs >> i & 1) : lhs_sign; },
             [&rhs](std::size_t i) { return (i < N) ? rhs[i] : rhs.sign(); });
@@ -621,8 +839,13 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        auto operator-(const T& other) const noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr auto operator-(const T& other) const noexcept {
+            constexpr std::size_t M = std::decay_t<T>::size();    
+            if constexpr (_is_limb_compatible<T>) {
+                integer<std::max(N, M), Word, Allocator, Signed> res = *this;
+                res._limb_sub_assign(other);
+                return res;
+            }
             return _bitwise_sub<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&other](std::size_t i) { return (i < M) ? other[i] : other.sign(); });
@@ -630,9 +853,14 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend auto operator-(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr auto operator-(const I& lhs, const_reference rhs) noexcept {
             constexpr std::size_t M = sizeof(I) * byte_size;
-            const bool lhs_sign = std::is_signed_v<I> ? std::signbit(lhs) : 0;
+            if constexpr (details::is_limb_v<word_type>) {
+                integer<std::max(N, M), Word, Allocator, Signed> res = integer<M, Word, void, std::is_signed_v<I>>(lhs);
+                res._limb_sub_assign(rhs);
+                return res;
+            }
+            const bool lhs_sign = details::int_signbit(lhs);
             return _bitwise_sub<M>(
             [&lhs, &lhs_sign](std::size_t i) { return (i < M) ? (lhs >> i & 1) : lhs_sign; },
             [&rhs](std::size_t i) { return (i < N) ? rhs[i] : rhs.sign(); });
@@ -640,9 +868,14 @@ namespace exlib {
 
         template<typename I>
         requires std::is_integral_v<I>
-        auto operator-(const I& val) const noexcept {
+        constexpr auto operator-(const I& val) const noexcept {
             constexpr std::size_t M = sizeof(I) * byte_size;
-            const bool val_sign = std::is_signed_v<I> ? std::signbit(val) : 0;
+            if constexpr (details::is_limb_v<word_type>) {
+                integer<std::max(N, M), Word, Allocator, Signed> res = *this;
+                res._limb_sub_assign(integer<M, Word, void, std::is_signed_v<I>>(val));
+                return res;
+            }
+            const bool val_sign = details::int_signbit(val);
             return _bitwise_sub<M>(
             [this](std::size_t i) { return (i < N) ? this->_at(i) : this->sign(); },
             [&val, &val_sign](std::size_t i) { return (i < M) ? (val >> i & 1) : val_sign; });
@@ -650,102 +883,127 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        bool operator==(const T& other) const noexcept {
+        constexpr bool operator==(const T& other) const noexcept {
             return this->_bitwise_equal(other);
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        bool operator==(const I& val) const noexcept {
+        constexpr bool operator==(const I& val) const noexcept {
             return this->_bitwise_equal(integer<sizeof(I) * byte_size, Word, Allocator, Signed>(val));
         }
 
         template <typename T> requires is_integer_v<T>
-        bool operator!=(const T& other) const noexcept {
+        constexpr bool operator!=(const T& other) const noexcept {
             return !(this->_bitwise_equal(other));
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        bool operator!=(const I& val) const noexcept {
+        constexpr bool operator!=(const I& val) const noexcept {
             return !(this->_bitwise_equal(integer<sizeof(I) * byte_size, Word, Allocator, Signed>(val)));
         }
 
-        self_type operator<<(auto&& other) const noexcept {
+        constexpr self_type operator<<(auto&& other) const noexcept {
             auto copy = *this;
             copy <<= other;
             return copy;
         }
 
-        reference operator<<=(auto&& x) {
+        constexpr reference operator<<=(auto&& x) {
             if (x < 0) {
                 throw std::runtime_error("left shifted bit count is negative!");
             }
             if (static_cast<std::size_t>(x) >= N) {
                 this->fill(0);
+            } else if constexpr (details::is_limb_v<word_type>) {
+                _limb_shl(static_cast<std::size_t>(x));
             } else {
                 for (std::size_t i = N - 1; ~i; i--) {
                     this->_at(i) = (i < static_cast<std::size_t>(x)) ? 0 : this->_at(i - static_cast<std::size_t>(x));
                 }
             }
+            _normalize();
             return *this;
         }
 
-        self_type operator>>(auto&& x) const noexcept {
+        constexpr self_type operator>>(auto&& x) const noexcept {
             auto copy = *this;
             copy >>= x;
             return copy;
         }
 
-        reference operator>>=(auto&& x) {
+        constexpr reference operator>>=(auto&& x) {
             if (x < 0) {
                 throw std::runtime_error("right shifted bit count is negative!");
             }
             if (static_cast<std::size_t>(x) >= N) {
                 this->fill(this->filling_mask());
+            } else if constexpr (details::is_limb_v<word_type>) {
+                _limb_shr(static_cast<std::size_t>(x));
             } else {
                 for (std::size_t i = 0; i < N; ++i) {
                     this->_at(i) = (i + static_cast<std::size_t>(x) < N) ? this->_at(i + static_cast<std::size_t>(x)) : sign();
                 }
             }   
+            _normalize();
             return *this;
         }
 
-        self_type operator~() const noexcept {
+        constexpr self_type operator~() const noexcept {
             auto copy = *this;
-            for (std::size_t i = 0; i < N; ++i) {
-                copy[i].flip();
+            if constexpr (details::is_limb_v<word_type>) {
+                for (std::size_t i = 0; i < array_size; ++i) {
+                    copy._data[i] = static_cast<word_type>(~copy._data[i]);
+                }
+                copy._normalize();
+            } else {
+                for (std::size_t i = 0; i < N; ++i) {
+                    copy[i].flip();
+                }
             }
             return copy;
         }
 
-        self_type operator++() noexcept {
+        constexpr self_type operator+() const noexcept {
+            return *this;
+        }
+
+        // two's complement negation, wraps like the builtin unsigned types
+        constexpr self_type operator-() const noexcept {
+            return self_type(0) - *this;
+        }
+
+        constexpr self_type operator++() noexcept {
             auto copy = *this;
             copy += 1;
             return copy;
         }
 
-        reference operator++(int) noexcept {
+        constexpr reference operator++(int) noexcept {
             *this += 1;
             return *this;
         }
 
-        self_type operator--() noexcept {
+        constexpr self_type operator--() noexcept {
             auto copy = *this;
             copy -= 1;
             return copy;
         }
 
-        reference operator--(int) noexcept {
+        constexpr reference operator--(int) noexcept {
             *this -= 1;
             return *this;
         }
 
         template<typename I, class Func>
         requires std::is_integral_v<I>
-        static bool _bitwise_compare(const I& lhs, const_reference rhs, Func op) noexcept {
+        constexpr static bool _bitwise_compare(const I& lhs, const_reference rhs, Func op) noexcept {
             constexpr std::size_t M = sizeof(I) * byte_size;
-            const bit lhs_sign = std::is_signed_v<I> ? std::signbit(lhs) : 0;
+            if constexpr (details::is_limb_v<word_type>) {
+                return op(integer<M, Word, void, std::is_signed_v<I>>(lhs)._limb_compare(rhs), 0);
+            }
+            const bit lhs_sign = details::int_signbit(lhs);
             if (lhs_sign != rhs.sign()) {
                 return op(lhs_sign, rhs.sign());
             }
@@ -763,8 +1021,11 @@ namespace exlib {
 
         template<typename T, class Func>
         requires is_integer_v<T>
-        bool _bitwise_compare(const T& other, Func op) const noexcept {
-            static constexpr std::size_t M = std::decay_t<T>::size();    
+        constexpr bool _bitwise_compare(const T& other, Func op) const noexcept {
+            if constexpr (_is_limb_repackable<T>) {
+                return op(_limb_compare(other), 0);
+            }
+            constexpr std::size_t M = std::decay_t<T>::size();    
             if (this->sign() != other.sign()) {
                 return !op(this->sign(), other.sign());
             }
@@ -782,92 +1043,92 @@ namespace exlib {
 
         template <typename T> 
         requires is_integer_v<T>
-        bool operator<(const T& other) const noexcept {
+        constexpr bool operator<(const T& other) const noexcept {
             return _bitwise_compare(other, [](const auto& l, const auto& r){ return l < r; });
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend bool operator<(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr bool operator<(const I& lhs, const_reference rhs) noexcept {
             return _bitwise_compare(lhs, rhs, [](const auto& l, const auto& r){ return l < r; });
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        bool operator<(const I& i) const noexcept {
+        constexpr bool operator<(const I& i) const noexcept {
             return *this < integer<sizeof(I) * byte_size, Word, Allocator, Signed>(i);
         }
 
         template <typename T> requires is_integer_v<T>
-        bool operator<=(const T& other) const noexcept {
+        constexpr bool operator<=(const T& other) const noexcept {
             return *this == other || *this < other;
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend bool operator<=(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr bool operator<=(const I& lhs, const_reference rhs) noexcept {
             return (rhs == lhs) || (rhs < lhs);
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        bool operator<=(const I& val) const noexcept {
+        constexpr bool operator<=(const I& val) const noexcept {
             return *this <= integer<sizeof(I) * byte_size, Word, Allocator, Signed>(val);
         }
 
         template <typename T> requires is_integer_v<T>
-        bool operator>(const T& other) const noexcept {
+        constexpr bool operator>(const T& other) const noexcept {
             return _bitwise_compare(other, [](const auto& l, const auto& r){ return l > r; });
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend bool operator>(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr bool operator>(const I& lhs, const_reference rhs) noexcept {
             return _bitwise_compare(lhs, rhs, [](const auto& l, const auto& r) { return l > r; });
         }
 
         template<typename I>
             requires std::is_integral_v<I>
-        bool operator>(const I& i) const noexcept {
+        constexpr bool operator>(const I& i) const noexcept {
             return _bitwise_compare(integer<sizeof(I) * byte_size, Word, Allocator, Signed>(i), [](const auto& l, const auto& r) { return l > r; });
         }
 
         template <typename T> requires is_integer_v<T>
-        bool operator>=(const T& other) const noexcept {
+        constexpr bool operator>=(const T& other) const noexcept {
             return *this == other || *this > other;
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        friend bool operator>=(const I& lhs, const_reference rhs) noexcept {
+        friend constexpr bool operator>=(const I& lhs, const_reference rhs) noexcept {
             return !(rhs < lhs);
         }
 
         template<typename I>
         requires std::is_integral_v<I>
-        bool operator>=(const I& val) const noexcept {
+        constexpr bool operator>=(const I& val) const noexcept {
             return *this >= integer<sizeof(I) * byte_size, Word, Allocator, Signed>(val);
         }
 
-        std::conditional_t<!Signed, const_reference, self_type> abs() const noexcept {
+        constexpr std::conditional_t<!Signed, const_reference, self_type> abs() const noexcept {
             if constexpr (!Signed) return *this;
             else return (sign() == 0) ? *this : ~(*this) + self_type(1);
         }
 
-        bit sign() const noexcept {
+        constexpr bit sign() const noexcept {
             if constexpr (!Signed) return 0;
             return this->_at(N - 1);
         }
 
-        inline void fill(word_type value = 0) noexcept {
+        constexpr inline void fill(word_type value = 0) noexcept {
             this->_data.fill(value);
         }
 
-        void swap(reference other) noexcept {
+        constexpr void swap(reference other) noexcept {
             std::swap(_data, other._data);
         }
 
-        auto filling_mask() const noexcept {
+        constexpr auto filling_mask() const noexcept {
             if constexpr (!Signed) {
                 return 0;
             }
@@ -879,89 +1140,186 @@ namespace exlib {
             return N;
         }
 
-        inline bit_reference _at(std::size_t pos) {
+        // bit scans over the N bit pattern, like the std:: functions on an unsigned type,
+        // a limb at a time. words that are not limbs are scanned bit by bit
+        constexpr std::size_t popcount() const noexcept {
+            if constexpr (details::is_limb_v<word_type>) {
+                std::size_t res = std::popcount(_top_word());
+                for (std::size_t i = 0; i + 1 < array_size; ++i) {
+                    res += std::popcount(_data[i]);
+                }
+                return res;
+            } else {
+                std::size_t res = 0;
+                for (std::size_t i = 0; i < N; ++i) {
+                    res += _at(i);
+                }
+                return res;
+            }
+        }
+
+        constexpr std::size_t countl_zero() const noexcept {
+            if constexpr (details::is_limb_v<word_type>) {
+                constexpr std::size_t pad = array_size * word_size - N;
+                if (const word_type top = _top_word(); top != 0) {
+                    return std::countl_zero(top) - pad;
+                }
+                for (std::size_t i = array_size - 1; i-- > 0;) {
+                    if (_data[i] != 0) {
+                        return (array_size - 1 - i) * word_size - pad + std::countl_zero(_data[i]);
+                    }
+                }
+                return N;
+            } else {
+                std::size_t i = N;
+                while (i > 0 && !_at(i - 1)) {
+                    --i;
+                }
+                return N - i;
+            }
+        }
+
+        constexpr std::size_t countr_zero() const noexcept {
+            return find_next(0);
+        }
+
+        constexpr std::size_t bit_width() const noexcept {
+            return N - countl_zero();
+        }
+
+        // the lowest set bit at pos or above, N when there is none
+        constexpr std::size_t find_next(std::size_t pos) const noexcept {
+            if (pos >= N) {
+                return N;
+            }
+            if constexpr (details::is_limb_v<word_type>) {
+                // bits above N copy the sign bit, which is found first
+                std::size_t i = pos / word_size;
+                word_type w = static_cast<word_type>(_data[i] & static_cast<word_type>(~static_cast<word_type>(0) << (pos % word_size)));
+                while (w == 0) {
+                    if (++i == array_size) {
+                        return N;
+                    }
+                    w = _data[i];
+                }
+                return i * word_size + std::countr_zero(w);
+            } else {
+                while (pos < N && !_at(pos)) {
+                    ++pos;
+                }
+                return pos;
+            }
+        }
+
+        // positions of the set bits in increasing order, for (std::size_t i : x.set_bits())
+        constexpr auto set_bits() const noexcept {
+            struct range {
+                set_bit_iterator _begin;
+
+                constexpr set_bit_iterator begin() const noexcept {
+                    return _begin;
+                }
+
+                constexpr set_bit_iterator end() const noexcept {
+                    return set_bit_iterator(*_begin._obj, N);
+                }
+            };
+            return range{set_bit_iterator(*this, find_next(0))};
+        }
+
+        // the top word with the bits above N cleared
+        constexpr word_type _top_word() const noexcept {
+            if constexpr (N % word_size == 0) {
+                return _data[array_size - 1];
+            } else {
+                return static_cast<word_type>(_data[array_size - 1] & static_cast<word_type>((static_cast<word_type>(1) << (N % word_size)) - 1));
+            }
+        }
+
+        constexpr inline bit_reference _at(std::size_t pos) {
             return bit_reference(*this, pos);
         }
 
-        inline bool _at(std::size_t pos) const {
-            return (this->_get_word(pos) & (1 << _which_bit(pos))) != static_cast<word_type>(0);
+        constexpr inline bool _at(std::size_t pos) const {
+            return (this->_get_word(pos) & (_mask_type(1) << _which_bit(pos))) != static_cast<word_type>(0);
         }
 
-        bit_reference at(std::size_t pos) {
+        constexpr bit_reference at(std::size_t pos) {
             if (pos >= N) [[unlikely]] {
                 throw std::out_of_range("pos out of range! " + std::to_string(pos) + " / " + std::to_string(N));
             }
             return bit_reference(*this, pos);
         }
 
-        bool at(std::size_t pos) const {
+        constexpr bool at(std::size_t pos) const {
             if (pos >= N) [[unlikely]] {
                 throw std::out_of_range("pos out of range! " + std::to_string(pos) + " / " + std::to_string(N));
             }
-            return (this->_get_word(pos) & (1 << _which_bit(pos))) != static_cast<word_type>(0);
+            return (this->_get_word(pos) & (_mask_type(1) << _which_bit(pos))) != static_cast<word_type>(0);
         }
 
-        iterator begin() noexcept {
+        constexpr iterator begin() noexcept {
             return iterator(*this, 0);
         }
 
-        iterator end() noexcept {
+        constexpr iterator end() noexcept {
             return iterator(*this, N);
         }
 
-        const_iterator cbegin() const noexcept {
+        constexpr const_iterator cbegin() const noexcept {
             return const_iterator(*this, 0);
         }
 
-        const_iterator cend() const noexcept {
+        constexpr const_iterator cend() const noexcept {
             return const_iterator(*this, N);
         }
         
-        bit_reference operator[](std::size_t pos) noexcept {
+        constexpr bit_reference operator[](std::size_t pos) noexcept {
             return bit_reference(*this, pos);
         }
 
-        bool operator[](std::size_t pos) const noexcept {
-            return (this->_get_word(pos) & (1 << _which_bit(pos))) != static_cast<word_type>(0);
+        constexpr bool operator[](std::size_t pos) const noexcept {
+            return (this->_get_word(pos) & (_mask_type(1) << _which_bit(pos))) != static_cast<word_type>(0);
         }
 
-        inline word_type& _get_word(std::size_t pos) noexcept {
+        constexpr inline word_type& _get_word(std::size_t pos) noexcept {
             return _data[_which_word(pos)];
         }
 
-        inline const word_type& _get_word(std::size_t pos) const noexcept {
+        constexpr inline const word_type& _get_word(std::size_t pos) const noexcept {
             return _data[_which_word(pos)];
         }
 
-        inline static std::size_t _which_word(std::size_t pos) noexcept {
+        constexpr inline static std::size_t _which_word(std::size_t pos) noexcept {
             return pos / word_size;
         }
 
-        inline static std::size_t _which_bit(std::size_t pos) noexcept {
+        constexpr inline static std::size_t _which_bit(std::size_t pos) noexcept {
             return pos % word_size;
         }
 
-        static std::pair<bit, bit> _full_add(bit x, bit y, bit c) noexcept {
+        constexpr static std::pair<bit, bit> _full_add(bit x, bit y, bit c) noexcept {
             bit sum = x ^ y ^ c;
             bit carry = (x & y) | ((x ^ y) & c);
             return {sum, carry};
         }
 
-        static std::pair<bit, bit> _full_sub(bit x, bit y, bit b) noexcept {
+        constexpr static std::pair<bit, bit> _full_sub(bit x, bit y, bit b) noexcept {
             bit diff = x ^ y ^ b;
             bit borrow = ((!x) & (y | b)) | (y & b);
             return {diff, borrow};
         }
 
-        static self_type max_value() noexcept {
+        constexpr static self_type max_value() noexcept {
             self_type res;
             std::fill(std::begin(res._data), std::end(res._data), -1);
             if (Signed) res._at(N - 1) = 0;
+            res._normalize();
             return res;
         }
 
         template<std::size_t M, typename LBitFunc, typename RBitFunc>
-        inline static auto _bitwise_add(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
+        constexpr inline static auto _bitwise_add(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
             // 使用位宽扩展 溢出不作处理
             using result_type = integer<std::max(N, M), Word, Allocator, Signed>;
             result_type res;
@@ -976,7 +1334,7 @@ namespace exlib {
         }
 
         template<std::size_t M, typename LBitFunc, typename RBitFunc>
-        inline reference _bitwise_add_assign(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
+        constexpr inline reference _bitwise_add_assign(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
             // 使用位宽扩展，溢出时不作处理
             bit carry = 0;
             
@@ -991,7 +1349,7 @@ namespace exlib {
         }
 
         template<std::size_t M, typename LBitFunc, typename RBitFunc>
-        inline static auto _bitwise_sub(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
+        constexpr inline static auto _bitwise_sub(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
             // 使用位宽扩展 溢出不作处理
             using result_type = integer<std::max(N, M), Word, Allocator, Signed>;
             result_type res;
@@ -1006,7 +1364,7 @@ namespace exlib {
         }
 
         template<std::size_t M, typename LBitFunc, typename RBitFunc>
-        inline reference _bitwise_sub_assign(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
+        constexpr inline reference _bitwise_sub_assign(LBitFunc lbitfunc, RBitFunc rbitfunc) noexcept {
             // 使用位宽扩展，溢出时不作处理
             bit borrow = 0;
             
@@ -1020,6 +1378,323 @@ namespace exlib {
             return *this;
         }
 
+        // keeps the bits above N in the top word equal to the sign bit
+        constexpr inline void _normalize() noexcept {
+            if constexpr (details::is_limb_v<word_type> && N % word_size != 0) {
+                constexpr word_type mask = static_cast<word_type>((static_cast<word_type>(1) << (N % word_size)) - 1);
+                word_type& top = _data[array_size - 1];
+                top = sign() ? static_cast<word_type>(top | static_cast<word_type>(~mask)) : static_cast<word_type>(top & mask);
+            }
+        }
+
+        // bits [i * B, (i + 1) * B) of the sign extended value, B being the width of W
+        template<typename W>
+        constexpr W _repack_word(std::size_t i) const noexcept {
+            constexpr std::size_t bits = details::limb_bits<W>;
+            const word_type fill = static_cast<word_type>(this->filling_mask());
+            if constexpr (bits == word_size) {
+                return static_cast<W>(i < array_size ? _data[i] : fill);
+            } else if constexpr (bits < word_size) {
+                constexpr std::size_t per = word_size / bits;
+                const word_type w = (i / per < array_size) ? _data[i / per] : fill;
+                return static_cast<W>(w >> (i % per * bits));
+            } else {
+                constexpr std::size_t per = bits / word_size;
+                W res = 0;
+                for (std::size_t k = 0; k < per; ++k) {
+                    const std::size_t j = i * per + k;
+                    res |= static_cast<W>(static_cast<W>((j < array_size) ? _data[j] : fill) << (k * word_size));
+                }
+                return res;
+            }
+        }
+
+        // -1, 0 or 1, scanning words of this type from the most significant one
+        // once the signs agree the sign extended words order like unsigned ones
+        template <typename T>
+        requires is_integer_v<T>
+        constexpr int _limb_compare(const T& other) const noexcept {
+            const bit lsign = sign();
+            const bit rsign = other.sign();
+            if (lsign != rsign) {
+                return lsign ? -1 : 1;
+            }
+            constexpr std::size_t m = (std::decay_t<T>::size() + word_size - 1) / word_size;
+            for (std::size_t i = std::max(array_size, m); i-- > 0;) {
+                const word_type l = _repack_word<word_type>(i);
+                const word_type r = other.template _repack_word<word_type>(i);
+                if (l != r) {
+                    return l < r ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        // whole limbs are moved first, the remaining cnt % word_size bits are
+        // funnel shifted across neighbouring limbs
+        constexpr void _limb_shl(std::size_t cnt) noexcept {
+            const std::size_t words = cnt / word_size;
+            const std::size_t bits = cnt % word_size;
+            if (words > 0) {
+                std::copy_backward(_data.begin(), _data.begin() + (array_size - words), _data.begin() + array_size);
+                std::fill(_data.begin(), _data.begin() + words, static_cast<word_type>(0));
+            }
+            if (bits > 0) {
+                details::limb_lshift(&_data[words], &_data[words], array_size - words, bits);
+            }
+            _normalize();
+        }
+
+        // the padding above N already holds the sign, so shifting the whole
+        // array in sign words is an arithmetic shift
+        constexpr void _limb_shr(std::size_t cnt) noexcept {
+            const word_type fill = static_cast<word_type>(this->filling_mask());
+            const std::size_t words = cnt / word_size;
+            const std::size_t bits = cnt % word_size;
+            if (words > 0) {
+                std::copy(_data.begin() + words, _data.begin() + array_size, _data.begin());
+                std::fill(_data.begin() + (array_size - words), _data.begin() + array_size, fill);
+            }
+            if (bits > 0) {
+                details::limb_rshift(&_data[0], &_data[0], array_size - words, bits, fill);
+            }
+        }
+
+        // word-wise addition, the shorter operand is sign extended a limb at a time
+        // returns the carry out of bit N - 1
+        template <typename T>
+        requires is_integer_v<T>
+        constexpr bit _limb_add_assign(const T& other) noexcept {
+            using other_type = std::decay_t<T>;
+            constexpr std::size_t m = std::min(array_size, other_type::array_size);
+            word_type* r = _data.data();
+            [[maybe_unused]] const bit l_pad = this->sign();
+            [[maybe_unused]] const bit r_pad = (other_type::size() > N) ? other._at(N) : other.sign();
+
+            word_type carry = details::limb_add_n(r, r, other._data.data(), m);
+            if constexpr (array_size > m) {
+                carry = details::limb_add_fill(r + m, r + m, array_size - m, static_cast<word_type>(other.filling_mask()), carry);
+            }
+            if constexpr (N % word_size != 0) {
+                // bit N of the top word is l_pad + r_pad + carry
+                carry = ((r[array_size - 1] >> (N % word_size)) & 1) ^ l_pad ^ r_pad;
+                _normalize();
+            }
+            return carry;
+        }
+
+        // word-wise subtraction, returns the borrow out of bit N - 1
+        template <typename T>
+        requires is_integer_v<T>
+        constexpr bit _limb_sub_assign(const T& other) noexcept {
+            using other_type = std::decay_t<T>;
+            constexpr std::size_t m = std::min(array_size, other_type::array_size);
+            word_type* r = _data.data();
+            [[maybe_unused]] const bit l_pad = this->sign();
+            [[maybe_unused]] const bit r_pad = (other_type::size() > N) ? other._at(N) : other.sign();
+
+            word_type borrow = details::limb_sub_n(r, r, other._data.data(), m);
+            if constexpr (array_size > m) {
+                borrow = details::limb_sub_fill(r + m, r + m, array_size - m, static_cast<word_type>(other.filling_mask()), borrow);
+            }
+            if constexpr (N % word_size != 0) {
+                borrow = ((r[array_size - 1] >> (N % word_size)) & 1) ^ l_pad ^ r_pad;
+                _normalize();
+            }
+            return borrow;
+        }
+
+        // this = lhs * rhs mod 2^N, both operands sign extended to N bits
+        // the product is accumulated straight into _data, which must not alias lhs or rhs
+        template <typename L, typename R>
+        requires is_integer_v<L> && is_integer_v<R>
+        constexpr void _limb_mul(const L& lhs, const R& rhs) noexcept {
+            constexpr std::size_t an = std::min(array_size, std::decay_t<L>::array_size);
+            constexpr std::size_t bn = std::min(array_size, std::decay_t<R>::array_size);
+            word_type* r = _data.data();
+            const word_type* a = lhs._data.data();
+            const word_type* b = rhs._data.data();
+
+            if constexpr (std::min(an, bn) >= details::default_mul_thresholds.full_product) {
+                // wide operands take the subquadratic path on a full product
+                constexpr std::size_t rn = std::min(an + bn, array_size);
+                details::limb_scratch<word_type> scratch(an + bn + details::limb_mul_scratch_size(an, bn));
+                details::limb_mul(scratch.data, a, an, b, bn, scratch.data + an + bn);
+                std::copy_n(scratch.data, rn, r);
+                std::fill(r + rn, r + array_size, static_cast<word_type>(0));
+            } else {
+                details::limb_mul_low(r, array_size, a, an, b, bn);
+            }
+
+            // a negative operand narrower than the result is a - 2^(an * word_size),
+            // which adds -2^(an * word_size) * rhs to the unsigned product
+            if constexpr (an < array_size) {
+                if (lhs.sign()) {
+                    constexpr std::size_t len = std::min(bn, array_size - an);
+                    word_type borrow = details::limb_sub_n(r + an, r + an, b, len);
+                    details::limb_sub_fill(r + an + len, r + an + len, array_size - an - len, static_cast<word_type>(rhs.filling_mask()), borrow);
+                }
+            }
+            if constexpr (bn < array_size) {
+                if (rhs.sign()) {
+                    constexpr std::size_t len = std::min(an, array_size - bn);
+                    word_type borrow = details::limb_sub_n(r + bn, r + bn, a, len);
+                    details::limb_sub_fill(r + bn + len, r + bn + len, array_size - bn - len, static_cast<word_type>(0), borrow);
+                }
+            }
+            _normalize();
+        }
+
+        // this += lhs * rhs mod 2^N, or -= when negate is set, the rows of the product go
+        // straight into _data with the operand signs folded into whether they are added or subtracted
+        template<typename L, typename R>
+        constexpr void _limb_fma(const L& lhs, const R& rhs, bit negate = false) {
+            constexpr std::size_t ln = std::decay_t<L>::array_size;
+            constexpr std::size_t rn = std::decay_t<R>::array_size;
+            // the rows overwrite _data while the operands are still read
+            if (static_cast<const void*>(&lhs) == this) {
+                const std::decay_t<L> copy = lhs;
+                _limb_fma(copy, rhs, negate);
+                return;
+            }
+            if (static_cast<const void*>(&rhs) == this) {
+                const std::decay_t<R> copy = rhs;
+                _limb_fma(lhs, copy, negate);
+                return;
+            }
+
+            // operands at least as wide as this need no sign handling, the low limbs
+            // of the two's complement product are already the ones that are kept
+            if constexpr (ln >= array_size && rn >= array_size) {
+                constexpr std::size_t n = array_size;
+                word_type* r = _data.data();
+                const word_type* a = lhs._data.data();
+                const word_type* b = rhs._data.data();
+                if (n >= details::default_mul_thresholds.full_product && !std::is_constant_evaluated()) {
+                    details::limb_scratch<word_type> p(2 * n + details::limb_mul_scratch_size(n, n));
+                    details::limb_mul(p.data, a, n, b, n, p.data + 2 * n);
+                    negate ? details::limb_sub_n(r, r, p.data, n) : details::limb_add_n(r, r, p.data, n);
+                } else {
+                    for (std::size_t i = 0; i < n; ++i) {
+                        negate ? details::limb_submul_1(r + i, a, n - i, b[i]) : details::limb_addmul_1(r + i, a, n - i, b[i]);
+                    }
+                }
+                _normalize();
+                return;
+            }
+            details::limb_scratch<word_type> mag((lhs.sign() ? ln : 0) + (rhs.sign() ? rn : 0));
+            const word_type* a = lhs._data.data();
+            const word_type* b = rhs._data.data();
+            if (lhs.sign()) {
+                lhs._limb_magnitude(mag.data);
+                a = mag.data;
+            }
+            if (rhs.sign()) {
+                rhs._limb_magnitude(mag.data + (lhs.sign() ? ln : 0));
+                b = mag.data + (lhs.sign() ? ln : 0);
+            }
+            const bit neg = (lhs.sign() != rhs.sign()) != negate;
+            std::size_t an = details::limb_trim(a, ln);
+            std::size_t bn = details::limb_trim(b, rn);
+            if (an < bn) {
+                std::swap(a, b);
+                std::swap(an, bn);
+            }
+            if (bn == 0) {
+                return;
+            }
+
+            word_type* r = _data.data();
+            word_type pending = 0;
+            if (bn >= details::default_mul_thresholds.karatsuba && !std::is_constant_evaluated()) {
+                details::limb_scratch<word_type> p(an + bn + details::limb_mul_scratch_size(an, bn));
+                details::limb_mul(p.data, a, an, b, bn, p.data + an + bn);
+                const std::size_t len = std::min(an + bn, array_size);
+                pending = neg ? details::limb_sub_n(r, r, p.data, len) : details::limb_add_n(r, r, p.data, len);
+            } else {
+                for (std::size_t i = 0; i < bn && i < array_size; ++i) {
+                    const std::size_t len = std::min(an, array_size - i);
+                    word_type c = neg ? details::limb_submul_1(r + i, a, len, b[i]) : details::limb_addmul_1(r + i, a, len, b[i]);
+                    if (i + len < array_size) {
+                        r[i + len] = neg ? details::sub_with_borrow(r[i + len], c, pending) : details::add_with_carry(r[i + len], c, pending);
+                    } else {
+                        pending = 0;
+                    }
+                }
+            }
+            for (std::size_t i = an + bn; pending != 0 && i < array_size; ++i) {
+                r[i] = neg ? details::sub_with_borrow(r[i], static_cast<word_type>(0), pending) : details::add_with_carry(r[i], static_cast<word_type>(0), pending);
+            }
+            _normalize();
+        }
+
+        // out[0, array_size) = |this| as an unsigned number
+        constexpr void _limb_magnitude(word_type* out) const noexcept {
+            std::copy_n(_data.begin(), array_size, out);
+            if (sign()) {
+                details::limb_neg(out, out, array_size);
+            }
+        }
+
+        // this = mag[0, n) zero extended, negated when neg is set
+        constexpr void _assign_magnitude(const word_type* mag, std::size_t n, bit neg) noexcept {
+            n = std::min(n, array_size);
+            std::copy_n(mag, n, _data.begin());
+            std::fill(_data.begin() + n, _data.begin() + array_size, static_cast<word_type>(0));
+            if (neg) {
+                details::limb_neg(_data.data(), _data.data(), array_size);
+            }
+            _normalize();
+        }
+
+        // word-wise long division of lhs by a nonzero rhs, truncating toward zero
+        // the remainder takes the sign of lhs, either output may be null or alias an operand
+        template <typename Q, typename Rem, typename L, typename R>
+        requires is_integer_v<L> && is_integer_v<R>
+        constexpr static void _limb_divmod(const L& lhs, const R& rhs, Q* quotient, Rem* remainder) {
+            constexpr std::size_t ln = std::decay_t<L>::array_size;
+            constexpr std::size_t rn = std::decay_t<R>::array_size;
+            details::limb_scratch<word_type> scratch(2 * ln + 2 * rn + details::limb_div_qr_scratch_size(ln, rn));
+            word_type* a = scratch.data;
+            word_type* d = a + ln;
+            word_type* q = d + rn;
+            word_type* r = q + ln;
+            const bit a_neg = lhs.sign();
+            const bit d_neg = rhs.sign();
+            lhs._limb_magnitude(a);
+            rhs._limb_magnitude(d);
+
+            std::size_t an = ln;
+            while (an > 0 && a[an - 1] == 0) {
+                --an;
+            }
+            std::size_t dn = rn;
+            while (dn > 0 && d[dn - 1] == 0) {
+                --dn;
+            }
+
+            std::size_t qn = 0;
+            std::size_t remn = an;
+            if (an < dn) {
+                std::copy_n(a, an, r);
+            } else if (dn == 1) {
+                qn = an;
+                r[0] = details::limb_divrem_1(q, a, an, d[0]);
+                remn = 1;
+            } else if constexpr (rn > 1) {
+                qn = an - dn + 1;
+                remn = dn;
+                details::limb_div_qr(quotient ? q : nullptr, remainder ? r : nullptr, a, an, d, dn, r + rn);
+            }
+
+            if (quotient) {
+                quotient->_assign_magnitude(q, qn, a_neg != d_neg);
+            }
+            if (remainder) {
+                remainder->_assign_magnitude(r, remn, a_neg);
+            }
+        }
+
         std::bitset<N> to_std_bitset() const noexcept {
             std::bitset<N> res; 
             res.reset();
@@ -1029,60 +1704,106 @@ namespace exlib {
             return res;
         }
 
-        operator bool() const noexcept {
+        constexpr operator bool() const noexcept {
             return (*this != 0);
         }
 
-        reference rd_bin_string(std::string s) noexcept {
-            this->fill(0);
-            bool neg = false;
-            if (s[0] == '-') {
-                neg = true;
-                s = s.substr(1, s.size() - 1);
-            }
-            for (std::size_t i = 0; i < N; ++i) {
-                this->_at(i) = (i < s.size()) ? (s[s.size() - 1 - i] - '0'): 0;
+        constexpr reference rd_bin_string(std::string_view s) noexcept {
+            if constexpr (details::is_limb_v<word_type>) {
+                this->fill(0);
+                _rd_chars(s.data(), s.data() + s.size(), 2, false);
+            } else {
+                integer<N, std::uint32_t, void, Signed> tmp;
+                tmp.rd_bin_string(s);
+                assign(tmp);
             }
+            return *this;
+        }
 
-            if (neg) {
-                *this = ~(*this) + 1;
+        // reads an optional '-' and decimal digits, stopping at the first other character
+        // values that do not fit wrap modulo 2^N, see exlib::from_chars for a checked parse
+        constexpr reference rd_string(std::string_view s) noexcept {
+            if constexpr (details::is_limb_v<word_type>) {
+                this->fill(0);
+                _rd_chars(s.data(), s.data() + s.size(), 10, false);
+            } else {
+                integer<N, std::uint32_t, void, Signed> tmp;
+                tmp.rd_string(s);
+                assign(tmp);
             }
             return *this;
         }
 
-        reference rd_string(std::string s) noexcept {
-            this->fill(0);
-            bool neg = false;
-            if (s[0] == '-') {
-                neg = true;
-                s = s.substr(1, s.size() - 1);
+        // std::from_chars for [first, last) in base 2, 8, 10 or 16, this is only written on success
+        // unless exact is unset, in which case out of range values wrap instead of failing
+        constexpr std::from_chars_result _rd_chars(const char* first, const char* last, int base, bool exact) requires details::is_limb_v<word_type> {
+            const bit neg = first != last && *first == '-';
+            const std::size_t bits = (base == 2) ? 1 : (base == 8) ? 3 : (base == 16) ? 4 : 0;
+            if ((neg && exact && !Signed) || (bits == 0 && base != 10)) {
+                return {first, std::errc::invalid_argument};
             }
-            
-            constexpr std::size_t M = digits10 * 4;
-            integer<M, details::uint4_t, void, false> src;
-            for (std::size_t i = 0; i < digits10; ++i) {
-                src._data[i] = (i < s.size()) ? (s[s.size() - 1 - i] - '0') : 0;
+            const char* begin = first + neg;
+            const char* end = begin;
+            while (end != last && details::limb_digit_values[static_cast<unsigned char>(*end)] < base) {
+                ++end;
+            }
+            if (end == begin) {
+                return {first, std::errc::invalid_argument};
             }
 
-            // Reverse double dabble
-            for (std::size_t i = 0; i < N; ++i) {
-                this->_at(N - 1) = src[0];
-                src >>= 1;
-                if (i != N - 1) {
-                    for (std::size_t j = 0; j < src.array_size; ++j) {
-                        if (src._data[j] >= 8) {
-                            src._data[j] -= 3;
-                        }
-                    }
-                    *this >>= 1;
+            const std::size_t len = static_cast<std::size_t>(end - begin);
+            const std::size_t mn = (bits == 0) ? details::limb_decimal_limbs<word_type>(len) : len * bits / word_size + 1;
+            details::limb_scratch<word_type> scratch(mn);
+            word_type* mag = scratch.data;
+            if (bits == 0) {
+                details::limb_from_decimal(mag, mn, begin, len);
+            } else {
+                details::limb_from_pow2(mag, mn, begin, len, bits);
+            }
+            const std::size_t n = details::limb_trim(mag, mn);
+
+            if (exact && n > 0) {
+                // |value| must stay below 2^(N - Signed), -2^(N - 1) being the one exception
+                const std::size_t width = (n - 1) * word_size + std::bit_width(mag[n - 1]);
+                const bool min_value = Signed && neg && width == N
+                                    && std::has_single_bit(mag[n - 1])
+                                    && std::all_of(mag, mag + n - 1, [](word_type w) { return w == 0; });
+                if (width > N - Signed && !min_value) {
+                    return {end, std::errc::result_out_of_range};
                 }
             }
+            _assign_magnitude(mag, n, neg);
+            return {end, std::errc{}};
+        }
+
+        // std::to_chars into [first, last) in base 2, 8, 10 or 16, lowercase and without prefix
+        constexpr std::to_chars_result _to_chars(char* first, char* last, int base) const requires details::is_limb_v<word_type> {
+            const std::size_t bits = (base == 2) ? 1 : (base == 8) ? 3 : (base == 16) ? 4 : 0;
+            const bit neg = sign();
+            details::limb_scratch<word_type> scratch(array_size);
+            word_type* mag = scratch.data;
+            _limb_magnitude(mag);
 
+            std::string dec;
+            std::size_t count;
+            if (bits == 0) {
+                dec = details::limb_to_decimal(mag, array_size);
+                count = dec.size();
+            } else {
+                count = std::max<std::size_t>(details::limb_pow2_digits(mag, array_size, bits), 1);
+            }
+            if (static_cast<std::size_t>(last - first) < neg + count) {
+                return {last, std::errc::value_too_large};
+            }
             if (neg) {
-                *this = ~(*this) + self_type(1);
+                *first++ = '-';
             }
-
-            return *this;
+            if (bits == 0) {
+                std::copy(dec.begin(), dec.end(), first);
+            } else {
+                details::limb_to_pow2(first, count, mag, array_size, bits);
+            }
+            return {first + count, std::errc{}};
         }
 
         std::string as_mantissa_str() const noexcept {
@@ -1110,87 +1831,145 @@ namespace exlib {
             return ss.str();
         } 
 
-        std::string str() const noexcept {
-            constexpr std::size_t M = digits10 * 4;
-            integer<M, details::uint4_t, void, false> res;
-            auto&& abs = this->abs();
+        // digits in base 2, 8, 10 or 16 with a leading '-' for negative values
+        constexpr std::string str(int base = 10) const noexcept {
+            if constexpr (!details::is_limb_v<word_type>) {
+                return integer<N, std::uint32_t, void, Signed>(*this).str(base);
+            } else if (base != 10) {
+                std::string res(N + 1, '0');
+                res.resize(static_cast<std::size_t>(_to_chars(res.data(), res.data() + res.size(), base).ptr - res.data()));
+                return res;
+            } else {
+                integer<N, Word, Allocator, false> mag = this->abs();
+                std::string res = details::limb_to_decimal(mag._data.data(), array_size);
+                if (sign()) {
+                    res.insert(res.begin(), '-');
+                }
+                return res;
+            }
+        }
 
-            // double dabble
-            for (std::size_t i = 0; i < N; ++i) {
-                res[0] = abs._at(N - 1 - i);
+        // the N bit two's complement pattern, leading zeros included
+        constexpr std::string bin() const noexcept {
+            return _pattern_str(1);
+        }
 
-                if (i != N - 1) {
-                    for (size_t j = 0; j < res._data.size(); ++j) {
-                        if (res._data[j] >= 5) {
-                            res._data[j] += 3;
-                        }
-                    }
+        constexpr std::string hex() const noexcept {
+            return _pattern_str(4);
+        }
 
-                    res <<= 1;
-                }
-            }
-            std::stringstream ss;
-            if (sign()) {
-                ss << "-";
+        constexpr std::string _pattern_str(std::size_t bits) const noexcept {
+            if constexpr (details::is_limb_v<word_type>) {
+                // padding above N is cleared in the unsigned copy
+                const integer<N, Word, Allocator, false> pattern = *this;
+                std::string res((N + bits - 1) / bits, '0');
+                details::limb_to_pow2(res.data(), res.size(), pattern._data.data(), array_size, bits);
+                return res;
+            } else {
+                return integer<N, std::uint32_t, void, Signed>(*this)._pattern_str(bits);
+            }
+        }
+
+        // bytes needed to hold the value in fmt, two's complement of a signed type keeps
+        // room for the sign bit
+        constexpr std::size_t byte_width(byte_format fmt = byte_format::twos_complement) const noexcept {
+            if constexpr (!details::is_limb_v<word_type>) {
+                return integer<N, std::uint32_t, void, Signed>(*this).byte_width(fmt);
+            } else if (fmt == byte_format::magnitude) {
+                details::limb_scratch<word_type> scratch(array_size);
+                _limb_magnitude(scratch.data);
+                const std::size_t n = details::limb_trim(scratch.data, array_size);
+                return n == 0 ? 0 : ((n - 1) * word_size + std::bit_width(scratch.data[n - 1]) + 7) / 8;
+            } else if (Signed && sign()) {
+                return ((~*this).bit_width() + 8) / 8;
+            } else {
+                return (bit_width() + Signed + 7) / 8;
             }
+        }
 
-            bool leading_zero = true;
-            for (std::size_t i = res.array_size - 1; ~i; i--) {
-                if (leading_zero && res._data[i] == 0) {
-                    continue;
+        // all of out is written, sign or zero extended past the value. the magnitude format
+        // leaves the sign to the caller. throws when out is shorter than byte_width(fmt)
+        constexpr void to_bytes(std::span<std::byte> out, std::endian order = std::endian::little, byte_format fmt = byte_format::twos_complement) const {
+            if constexpr (!details::is_limb_v<word_type>) {
+                integer<N, std::uint32_t, void, Signed>(*this).to_bytes(out, order, fmt);
+            } else {
+                if (out.size() < byte_width(fmt)) {
+                    throw std::runtime_error("to_bytes buffer is too small");
+                }
+                if (fmt == byte_format::magnitude) {
+                    details::limb_scratch<word_type> scratch(array_size);
+                    _limb_magnitude(scratch.data);
+                    details::limb_to_bytes(out.data(), out.size(), scratch.data, array_size, order, std::byte{0});
                 } else {
-                    leading_zero = false;
-                    ss << res._data[i];
+                    // the padding above N already holds the sign
+                    details::limb_to_bytes(out.data(), out.size(), _data.data(), array_size, order, sign() ? std::byte{0xff} : std::byte{0});
                 }
             }
-
-            if (ss.str().empty()) {
-                ss << "0";
-            }
-            return ss.str();
         }
 
-        std::string bin() const noexcept {
-            std::string res;
-            for (std::size_t i = N - 1; ~i; i--) {
-                res += ('0' + this->_at(i));
+        // the value as written by to_bytes, wrapped to N bits like a narrowing assignment.
+        // two's complement bytes are sign extended for signed types, neg gives the sign of
+        // a magnitude
+        constexpr reference from_bytes(std::span<const std::byte> in, std::endian order = std::endian::little,
+                                       byte_format fmt = byte_format::twos_complement, bool neg = false) {
+            if constexpr (!details::is_limb_v<word_type>) {
+                integer<N, std::uint32_t, void, Signed> tmp;
+                tmp.from_bytes(in, order, fmt, neg);
+                // bit by bit so the padding stays clear as the arithmetic leaves it
+                this->fill(0);
+                for (std::size_t i = 0; i < N; ++i) {
+                    this->_at(i) = tmp._at(i);
+                }
+                return *this;
+            } else if (fmt == byte_format::magnitude) {
+                details::limb_scratch<word_type> scratch(array_size);
+                details::limb_from_bytes(scratch.data, array_size, in.data(), in.size(), order, std::byte{0});
+                _assign_magnitude(scratch.data, array_size, neg);
+                return *this;
+            } else {
+                const std::byte top = in.empty() ? std::byte{0} : in[order == std::endian::big ? 0 : in.size() - 1];
+                const bool fill = Signed && (top & std::byte{0x80}) != std::byte{0};
+                details::limb_from_bytes(_data.data(), array_size, in.data(), in.size(), order, fill ? std::byte{0xff} : std::byte{0});
+                _normalize();
+                return *this;
             }
-            return res;
         }
 
-        std::string hex() const noexcept {
-            std::stringstream ss;
-            std::size_t n = N / 4;
-            std::size_t r = N % 4;
-
-            for (std::size_t i = 0; i < n; ++i) {
-                std::uint32_t x = this->_at(i * 4) + (this->_at(i * 4 + 1) * 2) + (this->_at(i * 4 + 2) * 4) + (this->_at(i * 4 + 3)) * 8;
-                ss << std::hex << x;                
-            }
-            uint32_t x = ((r >= 0) ? this->_at(n * 4) : 0) + ((r >= 1) ? this->_at(n * 4 + 1) * 2 : 0) + ((r >= 2) ? this->_at(n * 4 + 2) * 4 : 0);
-            ss << std::hex << x;
-
-            std::string res;
-            ss >> res;
-            std::reverse(res.begin(), res.end());
-            return res;
+        // the limbs in place, native byte order and two's complement with the padding above
+        // N holding the sign. a zero-copy view that lives as long as this
+        std::span<const std::byte> as_bytes() const noexcept requires std::is_void_v<Allocator> && details::is_limb_v<word_type> {
+            return std::as_bytes(std::span<const word_type, array_size>(_data.data(), array_size));
         }
 
+        // limb words are summed a word at a time, the value wraps to the width of I
         template<typename I>
         requires std::is_integral_v<I>
-        operator I() const noexcept {
-            I base = static_cast<I>(1);
-            I res = static_cast<I>(0);
+        constexpr operator I() const noexcept {
+            if constexpr (details::is_limb_v<word_type> && !std::is_same_v<I, bool>) {
+                using U = std::make_unsigned_t<I>;
+                constexpr std::size_t bits = sizeof(U) * CHAR_BIT;
+                U res = 0;
+                for (std::size_t i = 0; i < array_size && i * word_size < bits; ++i) {
+                    res |= static_cast<U>(static_cast<U>(_data[i]) << (i * word_size));
+                }
+                if (array_size * word_size < bits && sign()) {
+                    res |= static_cast<U>(~U(0) << (array_size * word_size));
+                }
+                return static_cast<I>(res);
+            } else {
+                I base = static_cast<I>(1);
+                I res = static_cast<I>(0);
 
-            for (std::size_t i = 0; i < N - Signed; ++i) {
-                res += base * this->_at(i);
-                base *= 2;
-            }
+                for (std::size_t i = 0; i < N - Signed; ++i) {
+                    res += base * this->_at(i);
+                    base *= 2;
+                }
 
-            if (Signed) {
-                res -= base * this->sign();
+                if (Signed) {
+                    res -= base * this->sign();
+                }
+                return res;
             }
-            return res;
         }
 
         struct iterator {
@@ -1202,50 +1981,50 @@ namespace exlib {
             using pointer = reference*;
             using iterator_category = std::random_access_iterator_tag;
             
-            iterator(integer& b, std::size_t pos) noexcept
+            constexpr iterator(integer& b, std::size_t pos) noexcept
             : _obj(b), _index(pos) {}
 
-            reference operator*() noexcept {
+            constexpr reference operator*() noexcept {
                 return reference(_obj, _index);
             }
 
-            inline iterator operator++() noexcept {
+            constexpr inline iterator operator++() noexcept {
                 auto copy = *this;
                 _index++;            
                 return copy;
             }
 
-            inline iterator& operator++(int) noexcept {
+            constexpr inline iterator& operator++(int) noexcept {
                 _index++;
                 return *this;
             }
 
-            inline iterator& operator+=(difference_type n) {
+            constexpr inline iterator& operator+=(difference_type n) {
                 _index += n;
                 return *this;
             }
 
-            inline iterator operator+(difference_type x) const noexcept {
+            constexpr inline iterator operator+(difference_type x) const noexcept {
                 auto copy = *this;
                 copy._index += x;
                 return copy;
             }
 
-            inline iterator operator-(difference_type x) const noexcept {
+            constexpr inline iterator operator-(difference_type x) const noexcept {
                 auto copy = *this;
                 copy._index -= x;
                 return copy;
             }
 
-            inline difference_type operator-(iterator other) const noexcept {
+            constexpr inline difference_type operator-(iterator other) const noexcept {
                 return _index - other._index;
             }
 
-            inline bool operator!=(const iterator& other) const noexcept {
+            constexpr inline bool operator!=(const iterator& other) const noexcept {
                 return _index != other._index;
             }
 
-            inline bool operator==(const iterator& other) const noexcept {
+            constexpr inline bool operator==(const iterator& other) const noexcept {
                 return _index == other._index;
             }
         };
@@ -1260,45 +2039,79 @@ namespace exlib {
             using pointer = reference*;
             using iterator_category = std::random_access_iterator_tag;
             
-            const_iterator(const integer& b, std::size_t pos) noexcept
+            constexpr const_iterator(const integer& b, std::size_t pos) noexcept
             : _obj(b), _index(pos) {}
 
-            const_reference operator*() const noexcept {
+            constexpr const_reference operator*() const noexcept {
                 return const_reference(_obj, _index);
             }
 
-            const_iterator operator++() noexcept {
+            constexpr const_iterator operator++() noexcept {
                 auto copy = *this;
                 _index++;            
                 return copy;
             }
 
-            const_iterator& operator++(int) noexcept {
+            constexpr const_iterator& operator++(int) noexcept {
                 _index++;
                 return *this;
             }
 
-            const_iterator operator+(difference_type x) noexcept {
+            constexpr const_iterator operator+(difference_type x) noexcept {
                 auto copy = *this;
                 copy._index += x;
                 return copy;
             }
 
-            const_iterator operator-(difference_type x) const noexcept {
+            constexpr const_iterator operator-(difference_type x) const noexcept {
                 auto copy = *this;
                 copy._index -= x;
                 return copy;
             }
 
-            difference_type operator-(const_iterator other) const noexcept {
+            constexpr difference_type operator-(const_iterator other) const noexcept {
                 return _index - other._index;
             }
 
-            bool operator!=(const const_iterator& other) const noexcept {
+            constexpr bool operator!=(const const_iterator& other) const noexcept {
                 return _index != other._index;
             }
 
-            bool operator==(const const_iterator& other) const noexcept {
+            constexpr bool operator==(const const_iterator& other) const noexcept {
+                return _index == other._index;
+            }
+        };
+
+        struct set_bit_iterator {
+            const integer* _obj;
+            std::size_t _index;
+            using value_type = std::size_t;
+            using reference = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            constexpr set_bit_iterator() noexcept
+            : _obj(nullptr), _index(N) {}
+
+            constexpr set_bit_iterator(const integer& b, std::size_t pos) noexcept
+            : _obj(&b), _index(pos) {}
+
+            constexpr std::size_t operator*() const noexcept {
+                return _index;
+            }
+
+            constexpr set_bit_iterator& operator++() noexcept {
+                _index = _obj->find_next(_index + 1);
+                return *this;
+            }
+
+            constexpr set_bit_iterator operator++(int) noexcept {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            constexpr bool operator==(const set_bit_iterator& other) const noexcept {
                 return _index == other._index;
             }
         };
@@ -1308,56 +2121,60 @@ namespace exlib {
             
             word_type* _word;
             std::size_t _b_pos;
+            // padding above N in the top word, set when this is the sign bit of a limb integer
+            _mask_type _pad = 0;
 
-            bit_reference(integer& b, std::size_t pos) noexcept {
+            constexpr bit_reference(integer& b, std::size_t pos) noexcept {
                 _word = &(b._get_word(pos));
                 _b_pos = integer::_which_bit(pos);
+                if constexpr (Signed && details::is_limb_v<word_type> && N % word_size != 0) {
+                    if (pos == N - 1) {
+                        _pad = static_cast<_mask_type>(~_mask_type(0) << (N % word_size));
+                    }
+                }
             }
 
             bit_reference(const bit_reference&) noexcept = default;
-            ~bit_reference() noexcept { }
+            constexpr ~bit_reference() noexcept { }
 
-            bit_reference& operator&=(bool x) noexcept {
+            constexpr bit_reference& operator&=(bool x) noexcept {
                 return *this = (this->value()) & x;
             }
 
-            bit_reference& operator|=(bool x) noexcept {
+            constexpr bit_reference& operator|=(bool x) noexcept {
                 return *this = (this->value()) | x;
             }
 
-            bit_reference& operator^=(bool x) noexcept {
+            constexpr bit_reference& operator^=(bool x) noexcept {
                 return *this = (this->value()) ^ x;
             }
 
-            bit_reference& operator=(bool x) noexcept {
-                if (x) *_word |= 1 << _b_pos;
-                else *_word &= ~(1 << _b_pos);
+            // writing the sign bit sign extends the padding, as _normalize() does
+            constexpr bit_reference& operator=(bool x) noexcept {
+                const _mask_type m = static_cast<_mask_type>((_mask_type(1) << _b_pos) | _pad);
+                if (x) *_word |= m;
+                else *_word &= ~m;
                 return *this;
             }
 
-            bit_reference& operator=(const bit_reference &other) noexcept {
-                if ((*other._word) & (1 << (other._b_pos))) 
-                    *_word |= (1 << _b_pos);
-                else 
-                    *_word &= ~(1 << _b_pos);
-                return *this;
+            constexpr bit_reference& operator=(const bit_reference &other) noexcept {
+                return *this = other.value();
             }
 
-            inline bool operator~() const noexcept {
-                return ((*_word) & (1 << _b_pos)) == 0;
+            constexpr inline bool operator~() const noexcept {
+                return ((*_word) & (_mask_type(1) << _b_pos)) == 0;
             }
 
-            inline operator bool() const noexcept {
-                return ((*_word) & (1 << _b_pos)) != 0; 
+            constexpr inline operator bool() const noexcept {
+                return ((*_word) & (_mask_type(1) << _b_pos)) != 0; 
             }
 
-            inline bool value() const noexcept {
-                return ((*_word) & (1 << _b_pos)) != 0; 
+            constexpr inline bool value() const noexcept {
+                return ((*_word) & (_mask_type(1) << _b_pos)) != 0; 
             }
 
-            bit_reference& flip() noexcept {
-                *_word ^= (1 << _b_pos);
-                return *this;
+            constexpr bit_reference& flip() noexcept {
+                return *this = !value();
             }
         };
 
@@ -1394,12 +2211,125 @@ struct std::common_type<Int1, Int2> {
     using type = std::conditional_t<(n > m), Int1, Int2>;
 };
 
-// formatter
+// formatter, the integer subset of the standard spec: [[fill]align][sign][#][0][width][type]
+// {:d} (the default), {:b}, {:B}, {:o}, {:x} and {:X} select the base, # adds the 0b, 0 or 0x
+// prefix and width may be an argument ({} or {n}). precision and L are rejected
 template <class Int>
 requires exlib::is_integer_v<Int>
-struct std::formatter<Int> : std::formatter<std::string> {
+struct std::formatter<Int> {
+    int base = 10;
+    char type = 'd';
+    char fill = ' ';
+    char align = 0;
+    char sign = '-';
+    bool alternate = false;
+    bool zero = false;
+    std::size_t width = 0;
+    std::size_t width_arg = 0;
+    bool dynamic_width = false;
+
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        const auto end = ctx.end();
+        auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+        auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+        if (it != end && *it != '}' && it + 1 != end && is_align(it[1])) {
+            if (*it == '{') {
+                throw std::format_error("invalid fill character for integer");
+            }
+            fill = *it;
+            align = it[1];
+            it += 2;
+        } else if (it != end && is_align(*it)) {
+            align = *it++;
+        }
+        if (it != end && (*it == '+' || *it == '-' || *it == ' ')) {
+            sign = *it++;
+        }
+        if (it != end && *it == '#') {
+            alternate = true;
+            ++it;
+        }
+        if (it != end && *it == '0') {
+            zero = true;
+            ++it;
+        }
+        if (it != end && *it == '{') {
+            dynamic_width = true;
+            if (++it != end && *it == '}') {
+                width_arg = ctx.next_arg_id();
+            } else {
+                for (; it != end && is_digit(*it); ++it) {
+                    width_arg = width_arg * 10 + static_cast<std::size_t>(*it - '0');
+                }
+                ctx.check_arg_id(width_arg);
+            }
+            if (it == end || *it != '}') {
+                throw std::format_error("invalid width argument for integer");
+            }
+            ++it;
+        } else {
+            for (; it != end && is_digit(*it); ++it) {
+                width = width * 10 + static_cast<std::size_t>(*it - '0');
+            }
+        }
+        if (it != end && *it != '}') {
+            switch (*it) {
+                case 'b': case 'B': base = 2; break;
+                case 'o': base = 8; break;
+                case 'x': case 'X': base = 16; break;
+                case 'd': break;
+                default: throw std::format_error("invalid format spec for integer");
+            }
+            type = *it++;
+        }
+        if (it != end && *it != '}') {
+            throw std::format_error("invalid format spec for integer");
+        }
+        return it;
+    }
+
     auto format(const auto& integer, auto& ctx) const {
-        return std::format_to(ctx.out(), "{}", integer.str());
+        std::size_t w = width;
+        if (dynamic_width) {
+            w = std::visit_format_arg([](auto v) -> std::size_t {
+                using V = decltype(v);
+                if constexpr (std::is_integral_v<V> && !std::is_same_v<V, bool> && !std::is_same_v<V, char>) {
+                    if constexpr (std::is_signed_v<V>) {
+                        if (v < 0) {
+                            throw std::format_error("negative width for integer");
+                        }
+                    }
+                    return static_cast<std::size_t>(v);
+                } else {
+                    throw std::format_error("width is not an integer");
+                }
+            }, ctx.arg(width_arg));
+        }
+
+        std::string digits = integer.str(base);
+        const bool neg = digits.front() == '-';
+        if (neg) {
+            digits.erase(digits.begin());
+        }
+        if (type == 'X') {
+            std::transform(digits.begin(), digits.end(), digits.begin(), [](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+        }
+        std::string prefix = neg ? "-" : (sign == '-' ? "" : std::string(1, sign));
+        if (alternate && base != 10 && !(base == 8 && digits == "0")) {
+            prefix += base == 8 ? std::string("0") : std::string{'0', type};
+        }
+
+        const std::size_t len = prefix.size() + digits.size();
+        const std::size_t pad = w > len ? w - len : 0;
+        std::string s;
+        if (align == 0 && zero) {
+            s = prefix + std::string(pad, '0') + digits;
+        } else {
+            const std::size_t left = align == '<' ? 0 : align == '^' ? pad / 2 : pad;
+            s = std::string(left, fill) + prefix + digits + std::string(pad - left, fill);
+        }
+        return std::copy(s.begin(), s.end(), ctx.out());
     }
 };
 
@@ -1407,31 +2337,387 @@ namespace exlib {
     template <typename Int>
     concept ExInt = std::is_integral_v<Int> || exlib::is_integer_v<Int>;
 
+    // a^b for b >= 0, square and multiply from the top bit of b, so b is only read
     template<class Int1, class Int2>
     requires ExInt<Int1> && ExInt<Int2>
-    std::common_type_t<Int1, Int2> pow(Int1 a, Int2 b) {
+    constexpr std::common_type_t<Int1, Int2> pow(Int1 a, Int2 b) {
         std::common_type_t<Int1, Int2> res = std::common_type_t<Int1, Int2>(1);
-        while (b) {
-            if (b & 1) res *= a;
-            a *= a;
-            b >>= 1;
+        if constexpr (is_integer_v<Int2>) {
+            for (std::size_t i = b.bit_width(); i-- > 0;) {
+                res *= res;
+                if (b[i]) res *= a;
+            }
+        } else {
+            using U = std::make_unsigned_t<Int2>;
+            for (std::size_t i = std::bit_width(static_cast<U>(b)); i-- > 0;) {
+                res *= res;
+                if ((static_cast<U>(b) >> i) & 1) res *= a;
+            }
         }
         return res;
     }
 
+    // quotient and remainder of a / b as a pair, from one division pass
     template<class Int1, class Int2>
-    requires ExInt<Int1> && ExInt<Int1>
-    std::common_type_t<Int1, Int2> gcd(Int1 a, Int2 b) {
-        if (b == 0) {
-            return a;
+    requires ExInt<Int1> && ExInt<Int2>
+    constexpr auto divmod(const Int1& a, const Int2& b) {
+        if constexpr (is_integer_v<Int1>) {
+            return a.divmod(b);
+        } else if constexpr (is_integer_v<Int2>) {
+            using type = std::decay_t<decltype(a / b)>;
+            return type(a).divmod(b);
+        } else {
+            return std::pair{a / b, a % b};
+        }
+    }
+
+    // the full product of a and b in N + M bits, so unlike operator* nothing is truncated
+    // the result is signed when either operand is and keeps the word and allocator of a
+    template<std::size_t N, std::size_t M, class Word1, class Word2, class Allocator1, class Allocator2, bool Signed1, bool Signed2>
+    constexpr auto mul_wide(const integer<N, Word1, Allocator1, Signed1>& a, const integer<M, Word2, Allocator2, Signed2>& b) {
+        using result_type = integer<N + M, Word1, Allocator1, Signed1 || Signed2>;
+        if constexpr (details::is_limb_v<Word1> && std::is_same_v<Word1, Word2>) {
+            result_type res;
+            res._limb_mul(a, b);
+            return res;
+        } else {
+            return result_type(a) * result_type(b);
+        }
+    }
+
+    // acc += a * b, the product is accumulated into acc without building it first
+    // and wraps modulo 2^N of acc like acc += mul_wide(a, b) would
+    template<class Acc, class Int1, class Int2>
+    requires is_integer_v<Acc> && is_integer_v<Int1> && is_integer_v<Int2>
+    constexpr Acc& fma(Acc& acc, const Int1& a, const Int2& b) {
+        using word_type = typename Acc::word_type;
+        if constexpr (details::is_limb_v<word_type>
+                   && std::is_same_v<word_type, typename Int1::word_type> && std::is_same_v<word_type, typename Int2::word_type>) {
+            acc._limb_fma(a, b);
+        } else {
+            acc += mul_wide(a, b);
+        }
+        return acc;
+    }
+
+    // parses an optional '-' and digits in base 2, 8, 10 or 16 into value like std::from_chars
+    // value is left untouched on errors, result_out_of_range when the number needs more than N bits
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr std::from_chars_result from_chars(const char* first, const char* last, Int& value, int base = 10) {
+        if constexpr (details::is_limb_v<typename Int::word_type>) {
+            return value._rd_chars(first, last, base, true);
+        } else {
+            integer<Int::size(), std::uint32_t, void, Int::is_signed_v> tmp;
+            auto res = tmp._rd_chars(first, last, base, true);
+            if (res.ec == std::errc{}) {
+                value = tmp;
+            }
+            return res;
         }
-        return gcd(b, a % b);
     }
 
+    // writes value in base 2, 8, 10 or 16 into [first, last) like std::to_chars
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr std::to_chars_result to_chars(char* first, char* last, const Int& value, int base = 10) {
+        if constexpr (details::is_limb_v<typename Int::word_type>) {
+            return value._to_chars(first, last, base);
+        } else {
+            return integer<Int::size(), std::uint32_t, void, Int::is_signed_v>(value)._to_chars(first, last, base);
+        }
+    }
+
+    namespace details {
+        // the limb type gcd works on, words that are not limbs go through uint32 words
+        template<class Int>
+        using gcd_type = integer<Int::size(), std::conditional_t<is_limb_v<typename Int::word_type>, typename Int::word_type, std::uint32_t>, void, Int::is_signed_v>;
+
+        // gcd(|x|, |y|)
+        template<class Int>
+        constexpr Int int_gcd(const Int& x, const Int& y) {
+            constexpr std::size_t n = Int::array_size;
+            limb_scratch<typename Int::word_type> t(3 * n);
+            x._limb_magnitude(t.data);
+            y._limb_magnitude(t.data + n);
+            Int res;
+            res._assign_magnitude(t.data + 2 * n, limb_gcd(t.data + 2 * n, t.data, n, t.data + n, n), false);
+            return res;
+        }
+
+        // gcd(|x|, |y|), with the magnitude of the cofactor s of |x|, s * |x| = g mod |y|,
+        // stored into s and its sign returned
+        template<class Int, class S>
+        constexpr bool int_gcdext(const Int& x, const Int& y, Int& g, S& s) {
+            constexpr std::size_t n = Int::array_size;
+            limb_scratch<typename Int::word_type> t(4 * n + 2);
+            x._limb_magnitude(t.data);
+            y._limb_magnitude(t.data + n);
+            std::size_t sn = 0;
+            bool neg = false;
+            g._assign_magnitude(t.data + 2 * n, limb_gcdext(t.data + 2 * n, t.data + 3 * n, sn, neg, t.data, n, t.data + n, n), false);
+            s._assign_magnitude(t.data + 3 * n, sn, false);
+            return neg;
+        }
+    }
+
+    // the greatest common divisor, never negative. binary gcd on short operands and
+    // lehmer's algorithm on long ones, both on the limbs of the magnitudes
     template<class Int1, class Int2>
-    requires ExInt<Int1> && ExInt<Int1>
-    std::common_type_t<Int1, Int2> lcm(Int1 a, Int2 b) {
-        auto t = a / gcd(a, b);
-        return a * b;
+    requires ExInt<Int1> && ExInt<Int2>
+    constexpr std::common_type_t<Int1, Int2> gcd(Int1 a, Int2 b) {
+        using type = std::common_type_t<Int1, Int2>;
+        if constexpr (std::is_integral_v<type>) {
+            return std::gcd(type(a), type(b));
+        } else {
+            using U = details::gcd_type<type>;
+            return type(details::int_gcd(U(a), U(b)));
+        }
+    }
+
+    // the least common multiple, never negative
+    template<class Int1, class Int2>
+    requires ExInt<Int1> && ExInt<Int2>
+    constexpr std::common_type_t<Int1, Int2> lcm(Int1 a, Int2 b) {
+        using type = std::common_type_t<Int1, Int2>;
+        if constexpr (std::is_integral_v<type>) {
+            return std::lcm(type(a), type(b));
+        } else {
+            const type x = a, y = b;
+            if (x == 0 || y == 0) {
+                return type(0);
+            }
+            const type res = x / gcd(x, y) * y;
+            return res < 0 ? type(0) - res : res;
+        }
+    }
+
+    // g = gcd(a, b) with a * s + b * t = g, returned as {g, s, t}. the cofactors are the
+    // small ones of euclid's algorithm, and wrap modulo 2^N for unsigned types
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr std::tuple<Int, Int, Int> xgcd(const Int& a, const Int& b) {
+        using U = details::gcd_type<Int>;
+        using wide_type = integer<2 * Int::size() + 2, typename U::word_type, void, true>;
+        U g;
+        wide_type s;
+        if (details::int_gcdext(U(a), U(b), g, s) != (a < 0)) {
+            s = wide_type(0) - s;
+        }
+        if (b == 0) {
+            return {Int(g), Int(s), Int(0)};
+        }
+        const wide_type t = (wide_type(g) - wide_type(a) * s) / wide_type(b);
+        return {Int(g), Int(s), Int(t)};
+    }
+
+    // the inverse of a modulo m > 0, in [0, m). a must be coprime to m
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr Int modinv(const Int& a, const Int& m) {
+        if (m <= 0) {
+            throw std::runtime_error("modinv modulus should be positive");
+        }
+        using U = details::gcd_type<Int>;
+        U r = U(a) % U(m);
+        if (r < 0) {
+            r += U(m);
+        }
+        U g, s;
+        const bool neg = details::int_gcdext(r, U(m), g, s);
+        if (g != 1) {
+            throw std::runtime_error("modinv of a value not coprime to the modulus");
+        }
+        return Int(neg ? U(m) - s : s);
+    }
+
+    namespace details {
+        // low 64 bits of an unsigned integer
+        template<class U>
+        constexpr std::uint64_t int_low_u64(const U& x) noexcept {
+            using W = typename U::word_type;
+            std::uint64_t res = 0;
+            for (std::size_t i = 0; i < U::array_size && i * limb_bits<W> < 64; ++i) {
+                res |= static_cast<std::uint64_t>(x._data[i]) << (i * limb_bits<W>);
+            }
+            return res;
+        }
+
+        // unsigned and 64 bits wider than Int, so squares just above its values still fit
+        template<class Int>
+        using root_type = integer<Int::size() + 64, std::conditional_t<is_limb_v<typename Int::word_type>, typename Int::word_type, std::uint32_t>, void, false>;
+
+        // whether i is a square modulo M, the perfect square prefilter
+        template<std::size_t M>
+        inline constexpr auto square_residues = [] {
+            std::array<bool, M> res{};
+            for (std::size_t i = 0; i < M; ++i) {
+                res[i * i % M] = true;
+            }
+            return res;
+        }();
+
+        // floor(sqrt(x)), the root of the top half of x seeds a single newton step,
+        // which leaves y at most a couple above the root. the top 52 bits go through double
+        template<class U>
+        constexpr U int_isqrt(const U& x) {
+            const std::size_t bits = x.bit_width();
+            if (bits <= 52) {
+                const std::uint64_t v = int_low_u64(x);
+                std::uint64_t r = 0;
+                if (std::is_constant_evaluated()) {
+                    r = v == 0 ? 0 : std::uint64_t(1) << ((std::bit_width(v) + 1) / 2);
+                    for (std::uint64_t z = r == 0 ? 0 : (r + v / r) / 2; z < r; z = (r + v / r) / 2) {
+                        r = z;
+                    }
+                } else {
+                    r = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(v)));
+                }
+                while (r * r > v) {
+                    --r;
+                }
+                while ((r + 1) * (r + 1) <= v) {
+                    ++r;
+                }
+                return U(r);
+            }
+            const std::size_t t = bits / 4;
+            U y = (int_isqrt(x >> (2 * t)) + 1) << t;
+            y = (y + x / y) >> 1;
+            // newton never undershoots, walk (y - 1)^2 = y^2 - 2y + 1 down to x
+            U sq = y * y;
+            while (sq > x) {
+                sq -= (y << 1) - 1;
+                y -= 1;
+            }
+            return y;
+        }
+
+        // floor(x^(1/k)) for k >= 2, newton seeded with the root of the top bits of x
+        template<class U>
+        constexpr U int_iroot(const U& x, std::size_t k) {
+            const std::size_t bits = x.bit_width();
+            if (bits <= k) {
+                return U(bits == 0 ? 0 : 1);
+            }
+            // ((k - 1) y + x / y^(k - 1)) / k, the power stops growing once it is above x
+            auto step = [&x, k, bits](const U& y) {
+                const std::size_t yb = y.bit_width();
+                U p = y;
+                for (std::size_t i = 1; i + 1 < k; ++i) {
+                    if (p.bit_width() + yb >= bits + 2) {
+                        return (y * (k - 1)) / k;
+                    }
+                    p *= y;
+                }
+                return (y * (k - 1) + x / p) / k;
+            };
+            const std::size_t t = bits / (2 * k);
+            U y;
+            if (t == 0) {
+                y = U(1) << ((bits + k - 1) / k);
+            } else {
+                y = step((int_iroot(x >> (k * t), k) + 1) << t);
+            }
+            // y is at or above the root from here on and newton only moves it down
+            for (U z = step(y); z < y; z = step(y)) {
+                y = z;
+            }
+            return y;
+        }
+    }
+
+    // floor(sqrt(x)) for x >= 0
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr Int isqrt(const Int& x) {
+        if (x < 0) {
+            throw std::runtime_error("isqrt of a negative integer");
+        }
+        using U = details::root_type<Int>;
+        return Int(details::int_isqrt(U(x)));
+    }
+
+    // the k-th root of x rounded toward zero, x may be negative for odd k
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr Int iroot(const Int& x, std::size_t k) {
+        if (k == 0) {
+            throw std::runtime_error("iroot of degree zero");
+        }
+        if (x < 0 && k % 2 == 0) {
+            throw std::runtime_error("even iroot of a negative integer");
+        }
+        using U = details::root_type<Int>;
+        const U m = x < 0 ? U(0) - U(x) : U(x);
+        const U r = k == 1 ? m : k == 2 ? details::int_isqrt(m) : details::int_iroot(m, k);
+        return x < 0 ? Int(0) - Int(r) : Int(r);
+    }
+
+    // squares modulo 64, 63, 65 and 11 reject all but about 1 in 300 non-squares
+    // before a square root is taken
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr bool is_perfect_square(const Int& x) {
+        if (x < 0) {
+            return false;
+        }
+        using U = details::root_type<Int>;
+        const U m(x);
+        if (!details::square_residues<64>[details::int_low_u64(m) & 63]) {
+            return false;
+        }
+        const std::uint64_t r = details::int_low_u64(U(m % 45045u));
+        if (!details::square_residues<63>[r % 63] || !details::square_residues<65>[r % 65] || !details::square_residues<11>[r % 11]) {
+            return false;
+        }
+        const U s = details::int_isqrt(m);
+        return s * s == m;
+    }
+
+    namespace details {
+        // parses the characters of an integer literal, digit separators and 0x/0b/0 prefixes included
+        // a malformed or too large literal throws, which is a compile error in a consteval context
+        template<class Int, char... Cs>
+        consteval Int parse_literal() {
+            constexpr char raw[] = {Cs...};
+            char buf[sizeof...(Cs)] = {};
+            std::size_t len = 0;
+            for (char c : raw) {
+                if (c != '\'') {
+                    buf[len++] = c;
+                }
+            }
+            int base = 10;
+            std::size_t skip = 0;
+            if (len > 2 && buf[0] == '0' && (buf[1] == 'x' || buf[1] == 'X')) {
+                base = 16, skip = 2;
+            } else if (len > 2 && buf[0] == '0' && (buf[1] == 'b' || buf[1] == 'B')) {
+                base = 2, skip = 2;
+            } else if (len > 1 && buf[0] == '0') {
+                base = 8, skip = 1;
+            }
+            Int res;
+            auto [ptr, ec] = res._rd_chars(buf + skip, buf + len, base, true);
+            if (ec != std::errc{} || ptr != buf + len) {
+                throw std::runtime_error("invalid integer literal");
+            }
+            return res;
+        }
+    }
+
+    // compile time constants, e.g. 0xffff'ffff'ffff'ffff'ffff_n128 or 340282366920938463463374607431768211455_u128
+    namespace literals {
+        template<char... Cs> consteval integer<64, unsigned int, void, true> operator""_n64() { return details::parse_literal<integer<64, unsigned int, void, true>, Cs...>(); }
+        template<char... Cs> consteval integer<128, unsigned int, void, true> operator""_n128() { return details::parse_literal<integer<128, unsigned int, void, true>, Cs...>(); }
+        template<char... Cs> consteval integer<256, unsigned int, void, true> operator""_n256() { return details::parse_literal<integer<256, unsigned int, void, true>, Cs...>(); }
+        template<char... Cs> consteval integer<512, unsigned int, void, true> operator""_n512() { return details::parse_literal<integer<512, unsigned int, void, true>, Cs...>(); }
+        template<char... Cs> consteval integer<1024, unsigned int, void, true> operator""_n1024() { return details::parse_literal<integer<1024, unsigned int, void, true>, Cs...>(); }
+
+        template<char... Cs> consteval integer<64, unsigned int, void, false> operator""_u64() { return details::parse_literal<integer<64, unsigned int, void, false>, Cs...>(); }
+        template<char... Cs> consteval integer<128, unsigned int, void, false> operator""_u128() { return details::parse_literal<integer<128, unsigned int, void, false>, Cs...>(); }
+        template<char... Cs> consteval integer<256, unsigned int, void, false> operator""_u256() { return details::parse_literal<integer<256, unsigned int, void, false>, Cs...>(); }
+        template<char... Cs> consteval integer<512, unsigned int, void, false> operator""_u512() { return details::parse_literal<integer<512, unsigned int, void, false>, Cs...>(); }
+        template<char... Cs> consteval integer<1024, unsigned int, void, false> operator""_u1024() { return details::parse_literal<integer<1024, unsigned int, void, false>, Cs...>(); }
     }
 }
\ No newline at end of file
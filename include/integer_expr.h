@@ -0,0 +1,294 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "integer.h"
+
+// opt-in expression templates over integer, lazy(a) * b + c - d builds a tree that is
+// evaluated once when it initializes or is assigned to an integer of the same type.
+// sums and differences are added into the destination in place and products are
+// accumulated there like fma, so no intermediate values are built. nodes refer to
+// their operands, so never keep an expression in auto
+
+namespace exlib {
+    template<class Int>
+    struct integer_ref;
+
+    template<class Int>
+    struct integer_const;
+
+    template<class Int, char Op, class L, class R>
+    struct integer_expr;
+
+    template<typename T>
+    struct is_integer_expr : std::false_type {};
+
+    template<class Int>
+    struct is_integer_expr<integer_ref<Int>> : std::true_type {};
+
+    template<class Int>
+    struct is_integer_expr<integer_const<Int>> : std::true_type {};
+
+    template<class Int, char Op, class L, class R>
+    struct is_integer_expr<integer_expr<Int, Op, L, R>> : std::true_type {};
+
+    template<typename T>
+    inline constexpr bool is_integer_expr_v = is_integer_expr<std::decay_t<T>>::value;
+
+    namespace details {
+        // adds x into r, or subtracts it when Neg is set, the first term is stored instead
+        template<bool Neg, class Int>
+        constexpr void expr_leaf_sum(typename Int::word_type* r, const Int& x, bool& started) noexcept {
+            constexpr std::size_t n = Int::array_size;
+            const auto* a = x._data.data();
+            if (!started) {
+                started = true;
+                if (Neg) {
+                    limb_neg(r, a, n);
+                } else if (a != r) {
+                    std::copy_n(a, n, r);
+                }
+            } else if (Neg) {
+                limb_sub_n(r, r, a, n);
+            } else {
+                limb_add_n(r, r, a, n);
+            }
+        }
+
+        // dst +-= l * r, operands that are not leaves are materialized first
+        template<bool Neg, class Int, class L, class R>
+        constexpr void expr_fma(Int& dst, const L& l, const R& r) {
+            if constexpr (L::leaf && R::leaf) {
+                dst._limb_fma(l._value(), r._value(), Neg);
+            } else if constexpr (L::leaf) {
+                dst._limb_fma(l._value(), Int(r), Neg);
+            } else if constexpr (R::leaf) {
+                dst._limb_fma(Int(l), r._value(), Neg);
+            } else {
+                dst._limb_fma(Int(l), Int(r), Neg);
+            }
+        }
+
+        template<class Int, class E>
+        constexpr void expr_evaluate(Int& dst, const E& e) {
+            if constexpr (!is_limb_v<typename Int::word_type>) {
+                dst = e._eager();
+            } else {
+                // the sums are written before the products are read, so dst may only be
+                // read as the first sum term, which is then updated in place
+                if (e._reads(&dst) > (e._first_sum() == &dst ? 1 : 0)) {
+                    const Int tmp(e);
+                    dst = tmp;
+                    return;
+                }
+                bool started = false;
+                e.template _sum<false>(dst._data.data(), started);
+                if (!started) {
+                    std::fill_n(dst._data.data(), Int::array_size, static_cast<typename Int::word_type>(0));
+                }
+                dst._normalize();
+                e.template _products<false>(dst);
+            }
+        }
+
+        template<class T, class Int>
+        concept expr_operand = (is_integer_expr_v<T> && std::is_same_v<typename std::decay_t<T>::integer_type, Int>)
+                            || std::is_same_v<std::decay_t<T>, Int> || std::is_integral_v<std::decay_t<T>>;
+
+        template<class L, class R>
+        struct expr_integer {
+            using type = typename std::decay_t<std::conditional_t<is_integer_expr_v<L>, L, R>>::integer_type;
+        };
+
+        // expression nodes as they are, integers by reference and builtin values by value
+        template<class Int, class T>
+        constexpr auto expr_node(const T& x) {
+            if constexpr (is_integer_expr_v<T>) {
+                return x;
+            } else if constexpr (std::is_same_v<T, Int>) {
+                return integer_ref<Int>(x);
+            } else {
+                return integer_const<Int>(x);
+            }
+        }
+
+        template<char Op, class L, class R>
+        constexpr auto expr_make(const L& l, const R& r) {
+            using Int = typename expr_integer<L, R>::type;
+            using left_type = decltype(expr_node<Int>(l));
+            using right_type = decltype(expr_node<Int>(r));
+            return integer_expr<Int, Op, left_type, right_type>(expr_node<Int>(l), expr_node<Int>(r));
+        }
+    }
+
+    // a leaf referring to an integer
+    template<class Int>
+    struct integer_ref {
+        using integer_type = Int;
+        inline static constexpr bool leaf = true;
+
+        const Int* _p;
+
+        constexpr explicit integer_ref(const Int& x) noexcept : _p(&x) {}
+
+        constexpr const Int& _value() const noexcept {
+            return *_p;
+        }
+
+        constexpr const Int& _eager() const noexcept {
+            return *_p;
+        }
+
+        constexpr std::size_t _reads(const Int* p) const noexcept {
+            return _p == p;
+        }
+
+        constexpr const Int* _first_sum() const noexcept {
+            return _p;
+        }
+
+        template<bool Neg>
+        constexpr void _sum(typename Int::word_type* r, bool& started) const noexcept {
+            details::expr_leaf_sum<Neg>(r, *_p, started);
+        }
+
+        template<bool Neg>
+        constexpr void _products(Int&) const noexcept {}
+
+        constexpr void _evaluate_into(Int& dst) const {
+            dst = *_p;
+        }
+    };
+
+    // a leaf holding a builtin value converted to Int
+    template<class Int>
+    struct integer_const {
+        using integer_type = Int;
+        inline static constexpr bool leaf = true;
+
+        Int _v;
+
+        template<typename I>
+        requires std::is_integral_v<I>
+        constexpr explicit integer_const(const I& x) noexcept : _v(x) {}
+
+        constexpr const Int& _value() const noexcept {
+            return _v;
+        }
+
+        constexpr const Int& _eager() const noexcept {
+            return _v;
+        }
+
+        constexpr std::size_t _reads(const Int*) const noexcept {
+            return 0;
+        }
+
+        constexpr const Int* _first_sum() const noexcept {
+            return &_v;
+        }
+
+        template<bool Neg>
+        constexpr void _sum(typename Int::word_type* r, bool& started) const noexcept {
+            details::expr_leaf_sum<Neg>(r, _v, started);
+        }
+
+        template<bool Neg>
+        constexpr void _products(Int&) const noexcept {}
+
+        constexpr void _evaluate_into(Int& dst) const {
+            dst = _v;
+        }
+    };
+
+    // l + r, l - r or l * r
+    template<class Int, char Op, class L, class R>
+    struct integer_expr {
+        using integer_type = Int;
+        inline static constexpr bool leaf = false;
+
+        L _l;
+        R _r;
+
+        constexpr integer_expr(const L& l, const R& r) : _l(l), _r(r) {}
+
+        constexpr Int _eager() const {
+            if constexpr (Op == '+') {
+                return _l._eager() + _r._eager();
+            } else if constexpr (Op == '-') {
+                return _l._eager() - _r._eager();
+            } else {
+                return _l._eager() * _r._eager();
+            }
+        }
+
+        constexpr std::size_t _reads(const Int* p) const noexcept {
+            return _l._reads(p) + _r._reads(p);
+        }
+
+        // the leftmost leaf that is added or subtracted rather than multiplied
+        constexpr const Int* _first_sum() const noexcept {
+            if constexpr (Op == '*') {
+                return nullptr;
+            } else {
+                const Int* p = _l._first_sum();
+                return p != nullptr ? p : _r._first_sum();
+            }
+        }
+
+        template<bool Neg>
+        constexpr void _sum(typename Int::word_type* r, bool& started) const noexcept {
+            if constexpr (Op != '*') {
+                _l.template _sum<Neg>(r, started);
+                _r.template _sum<Op == '-' ? !Neg : Neg>(r, started);
+            }
+        }
+
+        template<bool Neg>
+        constexpr void _products(Int& dst) const {
+            if constexpr (Op == '*') {
+                details::expr_fma<Neg>(dst, _l, _r);
+            } else {
+                _l.template _products<Neg>(dst);
+                _r.template _products<Op == '-' ? !Neg : Neg>(dst);
+            }
+        }
+
+        constexpr void _evaluate_into(Int& dst) const {
+            details::expr_evaluate(dst, *this);
+        }
+    };
+
+    // marks x as the start of a lazily evaluated expression
+    template<class Int>
+    requires is_integer_v<Int>
+    constexpr integer_ref<Int> lazy(const Int& x) noexcept {
+        return integer_ref<Int>(x);
+    }
+
+    template<class L, class R>
+    requires (is_integer_expr_v<L> || is_integer_expr_v<R>)
+          && details::expr_operand<L, typename details::expr_integer<L, R>::type>
+          && details::expr_operand<R, typename details::expr_integer<L, R>::type>
+    constexpr auto operator+(const L& l, const R& r) {
+        return details::expr_make<'+'>(l, r);
+    }
+
+    template<class L, class R>
+    requires (is_integer_expr_v<L> || is_integer_expr_v<R>)
+          && details::expr_operand<L, typename details::expr_integer<L, R>::type>
+          && details::expr_operand<R, typename details::expr_integer<L, R>::type>
+    constexpr auto operator-(const L& l, const R& r) {
+        return details::expr_make<'-'>(l, r);
+    }
+
+    template<class L, class R>
+    requires (is_integer_expr_v<L> || is_integer_expr_v<R>)
+          && details::expr_operand<L, typename details::expr_integer<L, R>::type>
+          && details::expr_operand<R, typename details::expr_integer<L, R>::type>
+    constexpr auto operator*(const L& l, const R& r) {
+        return details::expr_make<'*'>(l, r);
+    }
+}
@@ -0,0 +1,192 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "integer.h"
+#include "details/limb_mont.h"
+
+namespace exlib {
+    // integers modulo a modulus shared by every modint<Int, Id>, set once with set_mod
+    // products are reduced with a precomputed barrett reciprocal, so any m > 0 works,
+    // even ones, unlike montgomery_context. use another Id for a second modulus
+    template<class Int, int Id = 0>
+    requires is_integer_v<Int>
+    struct modint {
+        using integer_type = Int;
+        using word_type = std::conditional_t<details::is_limb_v<typename Int::word_type>, typename Int::word_type, std::uint32_t>;
+        using value_type = integer<Int::size(), word_type, void, false>;
+        using mu_type = integer<Int::size() + 2 * details::limb_bits<word_type>, word_type, void, false>;
+        using self_type = modint<Int, Id>;
+        using reference = self_type&;
+        using const_reference = const self_type&;
+
+        inline static integer_type _modulus = 0;
+        inline static value_type _m;
+        inline static mu_type _mu;
+        inline static std::size_t _n = 0;
+
+        // always in [0, m)
+        value_type _v;
+
+        static void set_mod(const integer_type& m) {
+            if (m <= 0) {
+                throw std::runtime_error("modint modulus should be positive");
+            }
+            _modulus = m;
+            _m = m;
+            _n = details::limb_trim(_m._data.data(), value_type::array_size);
+            _mu = 0;
+            details::limb_barrett_mu(_mu._data.data(), _m._data.data(), _n);
+        }
+
+        static const integer_type& mod() noexcept {
+            return _modulus;
+        }
+
+        modint() noexcept : _v(0) {}
+
+        template<typename I>
+        requires std::is_integral_v<I> || is_integer_v<I>
+        modint(const I& x) {
+            if (_n == 0) {
+                throw std::runtime_error("modint modulus is not set");
+            }
+            if constexpr (std::is_integral_v<I>) {
+                // wide enough for any builtin value and for the modulus
+                using wide_type = integer<std::max<std::size_t>(Int::size(), 64) + 1, word_type, void, true>;
+                wide_type r = wide_type(x) % wide_type(_modulus);
+                if (r < 0) {
+                    r += wide_type(_modulus);
+                }
+                _v = r;
+            } else {
+                using wide_type = integer<std::max(Int::size(), I::size()) + 1, word_type, void, true>;
+                wide_type r = wide_type(x) % wide_type(_modulus);
+                if (r < 0) {
+                    r += wide_type(_modulus);
+                }
+                _v = r;
+            }
+        }
+
+        integer_type value() const noexcept {
+            return integer_type(_v);
+        }
+
+        reference operator+=(const_reference other) noexcept {
+            details::limb_mont_add(_v._data.data(), _v._data.data(), other._v._data.data(), _m._data.data(), _n);
+            return *this;
+        }
+
+        reference operator-=(const_reference other) noexcept {
+            details::limb_mont_sub(_v._data.data(), _v._data.data(), other._v._data.data(), _m._data.data(), _n);
+            return *this;
+        }
+
+        reference operator*=(const_reference other) {
+            const std::size_t k = std::max(details::limb_mul_scratch_size(_n, _n), details::limb_barrett_reduce_scratch_size(_n));
+            details::limb_scratch<word_type> t(2 * _n + k);
+            details::limb_mul(t.data, _v._data.data(), _n, other._v._data.data(), _n, t.data + 2 * _n);
+            details::limb_barrett_reduce(_v._data.data(), t.data, _m._data.data(), _mu._data.data(), _n, t.data + 2 * _n);
+            return *this;
+        }
+
+        reference operator/=(const_reference other) {
+            return *this *= other.inv();
+        }
+
+        self_type operator+(const_reference other) const noexcept {
+            auto copy = *this;
+            copy += other;
+            return copy;
+        }
+
+        self_type operator-(const_reference other) const noexcept {
+            auto copy = *this;
+            copy -= other;
+            return copy;
+        }
+
+        self_type operator*(const_reference other) const {
+            auto copy = *this;
+            copy *= other;
+            return copy;
+        }
+
+        self_type operator/(const_reference other) const {
+            auto copy = *this;
+            copy /= other;
+            return copy;
+        }
+
+        self_type operator+() const noexcept {
+            return *this;
+        }
+
+        self_type operator-() const noexcept {
+            return self_type() - *this;
+        }
+
+        bool operator==(const_reference other) const noexcept {
+            return _v == other._v;
+        }
+
+        // x^e for e >= 0, square and multiply from the top bit
+        template<class E>
+        requires std::is_integral_v<E> || is_integer_v<E>
+        self_type pow(const E& e) const {
+            if (!std::is_unsigned_v<E> && e < 0) {
+                throw std::runtime_error("negative exponent in modint pow");
+            }
+            const integer<details::int_bits_v<E>, word_type, void, false> x(e);
+            self_type res = 1;
+            for (std::size_t i = x.bit_width(); i-- > 0;) {
+                res *= res;
+                if (x[i]) {
+                    res *= *this;
+                }
+            }
+            return res;
+        }
+
+        // multiplicative inverse by the extended gcd, x must be coprime to m
+        self_type inv() const {
+            value_type g, s;
+            const bool neg = details::int_gcdext(_v, _m, g, s);
+            if (g != 1) {
+                throw std::runtime_error("modint is not invertible");
+            }
+            self_type res;
+            res._v = neg ? _m - s : s;
+            return res;
+        }
+
+        std::string str() const noexcept {
+            return _v.str();
+        }
+
+        // a field has no proper gcd, any nonzero element divides the other
+        friend self_type gcd(const_reference a, const_reference b) noexcept {
+            return a == self_type() ? b : a;
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const_reference x) noexcept {
+            os << x.str();
+            return os;
+        }
+    };
+}
+
+template<class Int, int Id>
+struct std::formatter<exlib::modint<Int, Id>> : std::formatter<std::string> {
+    auto format(const auto& x, auto& ctx) const {
+        return std::formatter<std::string>::format(x.str(), ctx);
+    }
+};
@@ -0,0 +1,207 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "integer.h"
+#include "details/limb_mont.h"
+
+namespace exlib {
+    // arithmetic modulo a fixed odd m > 1 in montgomery form, x is kept as x * R mod m
+    // with R = 2^(limb bits * limbs of m). values from to_mont, one, mul, sqr, add, sub
+    // and pow stay in that form until from_mont turns them back
+    template<class Int>
+    requires is_integer_v<Int>
+    struct montgomery_context {
+        using integer_type = Int;
+        using word_type = std::conditional_t<details::is_limb_v<typename Int::word_type>, typename Int::word_type, std::uint32_t>;
+        using value_type = integer<Int::size(), word_type, void, false>;
+
+        integer_type _modulus;
+        value_type _m;
+        value_type _r2;
+        value_type _one;
+        word_type _minv;
+        std::size_t _n;
+
+        explicit montgomery_context(const integer_type& m) : _modulus(m), _m(m) {
+            if (m <= 1 || (m & 1) == 0) {
+                throw std::runtime_error("montgomery modulus should be odd and greater than 1");
+            }
+            _n = details::limb_trim(_m._data.data(), value_type::array_size);
+            _minv = details::limb_mont_minv(_m._data[0]);
+
+            // R^2 mod m from one division of B^(2n)
+            std::vector<word_type> a(2 * _n + 1, 0);
+            a[2 * _n] = 1;
+            if (_n == 1) {
+                _r2._data[0] = details::limb_divrem_1(a.data(), a.data(), a.size(), _m._data[0]);
+            } else {
+                details::limb_scratch<word_type> scratch(details::limb_div_qr_scratch_size(a.size(), _n));
+                details::limb_div_qr<word_type>(nullptr, _r2._data.data(), a.data(), a.size(), _m._data.data(), _n, scratch.data);
+            }
+            _one = _reduce(_r2);
+        }
+
+        const integer_type& modulus() const noexcept {
+            return _modulus;
+        }
+
+        // 1 in montgomery form, R mod m
+        const value_type& one() const noexcept {
+            return _one;
+        }
+
+        value_type to_mont(const integer_type& x) const {
+            integer_type r = x % _modulus;
+            if (r < 0) {
+                r += _modulus;
+            }
+            return mul(value_type(r), _r2);
+        }
+
+        integer_type from_mont(const value_type& x) const {
+            return integer_type(_reduce(x));
+        }
+
+        value_type mul(const value_type& a, const value_type& b) const {
+            value_type r;
+            details::limb_mont_mul(r._data.data(), a._data.data(), b._data.data(), _m._data.data(), _n, _minv);
+            return r;
+        }
+
+        value_type sqr(const value_type& a) const {
+            value_type r;
+            details::limb_mont_sqr(r._data.data(), a._data.data(), _m._data.data(), _n, _minv);
+            return r;
+        }
+
+        value_type add(const value_type& a, const value_type& b) const noexcept {
+            value_type r;
+            details::limb_mont_add(r._data.data(), a._data.data(), b._data.data(), _m._data.data(), _n);
+            return r;
+        }
+
+        value_type sub(const value_type& a, const value_type& b) const noexcept {
+            value_type r;
+            details::limb_mont_sub(r._data.data(), a._data.data(), b._data.data(), _m._data.data(), _n);
+            return r;
+        }
+
+        // a^e for a in montgomery form and e >= 0, left to right over sliding windows of e
+        // only the odd powers a, a^3, .. a^(2^k - 1) are tabulated
+        template<class E>
+        requires std::is_integral_v<E> || is_integer_v<E>
+        value_type pow(const value_type& a, const E& e) const {
+            constexpr std::size_t ebits = details::int_bits_v<E>;
+            using exponent_type = integer<ebits, word_type, void, false>;
+            if (_is_negative(e)) {
+                throw std::runtime_error("negative exponent in montgomery pow");
+            }
+            const exponent_type x(e);
+            constexpr std::size_t wb = details::limb_bits<word_type>;
+            const std::size_t bits = x.bit_width();
+            if (bits == 0) {
+                return _one;
+            }
+            auto bit_at = [&x](std::size_t i) { return (x._data[i / wb] >> (i % wb)) & 1; };
+
+            const std::size_t k = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : bits > 7 ? 2 : 1;
+            std::vector<value_type> table(std::size_t(1) << (k - 1));
+            table[0] = a;
+            if (table.size() > 1) {
+                const value_type a2 = sqr(a);
+                for (std::size_t i = 1; i < table.size(); ++i) {
+                    table[i] = mul(table[i - 1], a2);
+                }
+            }
+
+            value_type res = _one;
+            bool first = true;
+            for (std::size_t i = bits; i > 0;) {
+                if (!bit_at(i - 1)) {
+                    res = sqr(res);
+                    --i;
+                    continue;
+                }
+                // the longest window [l, i) of at most k bits that ends in a set bit
+                const std::size_t l = x.find_next(i > k ? i - k : 0);
+                std::size_t w = 0;
+                for (std::size_t j = i; j > l; --j) {
+                    w = (w << 1) | bit_at(j - 1);
+                }
+                if (first) {
+                    res = table[w >> 1];
+                    first = false;
+                } else {
+                    for (std::size_t j = l; j < i; ++j) {
+                        res = sqr(res);
+                    }
+                    res = mul(res, table[w >> 1]);
+                }
+                i = l;
+            }
+            return res;
+        }
+
+        // a^e mod m for an ordinary a
+        template<class E>
+        requires std::is_integral_v<E> || is_integer_v<E>
+        integer_type powmod(const integer_type& a, const E& e) const {
+            return from_mont(pow(to_mont(a), e));
+        }
+
+        template<class E>
+        static constexpr bool _is_negative(const E& e) noexcept {
+            if constexpr (is_integer_v<E>) {
+                return e < 0;
+            } else {
+                return details::int_signbit(e);
+            }
+        }
+
+        // a / R mod m, the montgomery reduction of a single width value
+        value_type _reduce(const value_type& a) const {
+            value_type one;
+            one._data[0] = 1;
+            return mul(a, one);
+        }
+    };
+
+    // a^e mod m for m > 0 and e >= 0, odd moduli go through a montgomery_context
+    template<class Int, class E>
+    requires is_integer_v<Int> && (std::is_integral_v<E> || is_integer_v<E>)
+    Int powmod(const Int& a, const E& e, const Int& m) {
+        if (m <= 0) {
+            throw std::runtime_error("powmod modulus should be positive");
+        }
+        if (m == 1) {
+            return Int(0);
+        }
+        if ((m & 1) != 0) {
+            return montgomery_context<Int>(m).powmod(a, e);
+        }
+        if (montgomery_context<Int>::_is_negative(e)) {
+            throw std::runtime_error("negative exponent in powmod");
+        }
+        // even moduli square and multiply in double width
+        using wide_type = integer<2 * Int::size(), typename montgomery_context<Int>::word_type, void, false>;
+        Int r = a % m;
+        if (r < 0) {
+            r += m;
+        }
+        const wide_type wm(m);
+        wide_type base(r), res(1);
+        const auto x = integer<details::int_bits_v<E>, typename montgomery_context<Int>::word_type, void, false>(e);
+        for (std::size_t i = x.bit_width(); i-- > 0;) {
+            res = res * res % wm;
+            if (x[i]) {
+                res = res * base % wm;
+            }
+        }
+        return Int(res);
+    }
+}
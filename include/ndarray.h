@@ -39,9 +39,9 @@ namespace exlib {
         using reverse_iterator = typename array_type::reverse_iterator;
         using const_reverse_iterator = typename array_type::const_reverse_iterator;
         
-        using self_type = ndarray<Shape, DType>;
-        using reference = ndarray<Shape, DType>&;
-        using const_reference = const ndarray<Shape, DType>&;
+        using self_type = ndarray<Shape, DType, Allocator>;
+        using reference = self_type&;
+        using const_reference = const self_type&;
 
         array_type data;
 
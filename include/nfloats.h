@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <bit>
 #include <bitset>
 #include <cmath>
 #include <csignal>
@@ -140,13 +142,7 @@ namespace exlib {
                 i = std::abs(i);
             }   
             constexpr std::size_t M = sizeof(i) * byte_size;
-            std::size_t len = 0;
-            for (std::size_t j = M - 1; ~j; j--) {
-                if (i >> j & 1) {
-                    len = j;
-                    break;
-                }
-            }
+            const std::size_t len = std::max<std::size_t>(std::bit_width(static_cast<std::make_unsigned_t<I>>(i)), 1) - 1;
 
             _exponent = len;
             if (M >= mantissa_size) {
@@ -169,13 +165,7 @@ namespace exlib {
                 i = i.abs();
             }
 
-            std::size_t len = 0;
-            for (std::size_t j = i.template size() - 1; ~j; j--) {
-                if (i[j]) {
-                    len = j;
-                    break;
-                }
-            }
+            const std::size_t len = std::max<std::size_t>(i.bit_width(), 1) - 1;
 
             _exponent = len;
             if (i.template size() >= mantissa_size) {
@@ -256,7 +246,7 @@ namespace exlib {
 
            
             _exponent += other._exponent + 1;
-            _mantissa = (unints<mantissa_size * 2>(_mantissa) * other._mantissa) >> (mantissa_size);
+            _mantissa = mul_wide(_mantissa, other._mantissa) >> (mantissa_size);
             _sign ^= other._sign;
 
             if (_exponent >= max_exponent_limits) {
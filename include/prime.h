@@ -0,0 +1,403 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "integer.h"
+#include "montgomery.h"
+
+// probable primes by trial division, then a base 2 miller-rabin and a strong lucas
+// test (baillie-psw), no composite is known to pass both
+
+namespace exlib {
+    namespace details {
+        inline constexpr std::size_t small_prime_bound = 1 << 16;
+
+        inline constexpr std::size_t small_prime_count = [] {
+            std::array<bool, small_prime_bound> composite{};
+            std::size_t count = 0;
+            for (std::size_t i = 3; i < small_prime_bound; i += 2) {
+                if (!composite[i]) {
+                    ++count;
+                    for (std::size_t j = i * i; j < small_prime_bound; j += 2 * i) {
+                        composite[j] = true;
+                    }
+                }
+            }
+            return count;
+        }();
+
+        // the odd primes below small_prime_bound
+        inline constexpr auto small_primes = [] {
+            std::array<bool, small_prime_bound> composite{};
+            std::array<std::uint32_t, small_prime_count> primes{};
+            std::size_t count = 0;
+            for (std::size_t i = 3; i < small_prime_bound; i += 2) {
+                if (!composite[i]) {
+                    primes[count++] = static_cast<std::uint32_t>(i);
+                    for (std::size_t j = i * i; j < small_prime_bound; j += 2 * i) {
+                        composite[j] = true;
+                    }
+                }
+            }
+            return primes;
+        }();
+
+        // is_probable_prime divides by the primes below 4096, next_prime sieves with more
+        inline constexpr std::size_t trial_prime_count = std::lower_bound(small_primes.begin(), small_primes.end(), 4096u) - small_primes.begin();
+
+        // runs of consecutive small primes whose product stays below 2^Bits, so one
+        // remainder of the product gives the remainders of all of them
+        struct small_prime_group {
+            std::uint64_t product;
+            std::uint32_t first;
+            std::uint32_t last;
+        };
+
+        template<std::size_t Bits>
+        constexpr std::size_t small_prime_groups_fill(small_prime_group* out) noexcept {
+            constexpr std::uint64_t limit = Bits >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << Bits) - 1;
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < small_prime_count;) {
+                small_prime_group g{small_primes[i], static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(i + 1)};
+                for (++i; i < small_prime_count && g.product <= limit / small_primes[i]; ++i) {
+                    g.product *= small_primes[i];
+                    g.last = static_cast<std::uint32_t>(i + 1);
+                }
+                if (out != nullptr) {
+                    out[count] = g;
+                }
+                ++count;
+            }
+            return count;
+        }
+
+        template<std::size_t Bits>
+        inline constexpr auto small_prime_groups = [] {
+            std::array<small_prime_group, small_prime_groups_fill<Bits>(nullptr)> groups{};
+            small_prime_groups_fill<Bits>(groups.data());
+            return groups;
+        }();
+
+        template<class W>
+        inline constexpr std::size_t small_group_bits = limb_bits<W> >= 64 ? 64 : 32;
+
+        // a[0, n) mod d for d < 2^small_group_bits<W>, narrow limbs are folded in by hand
+        template<class W>
+        constexpr std::uint64_t limb_mod_small(const W* a, std::size_t n, std::uint64_t d) noexcept {
+            if constexpr (limb_bits<W> >= 32) {
+                return limb_mod_1<W>(a, n, static_cast<W>(d));
+            } else {
+                std::uint64_t r = 0;
+                for (std::size_t i = n; i-- > 0;) {
+                    r = ((r << limb_bits<W>) | a[i]) % d;
+                }
+                return r;
+            }
+        }
+
+        // x mod p for at least the first count small primes p
+        template<class U>
+        void int_small_residues(const U& x, std::uint32_t* r, std::size_t count) {
+            using W = typename U::word_type;
+            const std::size_t n = limb_trim(x._data.data(), U::array_size);
+            for (const auto& g : small_prime_groups<small_group_bits<W>>) {
+                if (g.first >= count) {
+                    break;
+                }
+                const std::uint64_t m = limb_mod_small(x._data.data(), n, g.product);
+                for (std::size_t i = g.first; i < g.last; ++i) {
+                    r[i] = static_cast<std::uint32_t>(m % small_primes[i]);
+                }
+            }
+        }
+
+        // whether a prime below 4096 divides x, x above small_prime_bound
+        template<class U>
+        bool int_has_small_factor(const U& x) {
+            using W = typename U::word_type;
+            const std::size_t n = limb_trim(x._data.data(), U::array_size);
+            for (const auto& g : small_prime_groups<small_group_bits<W>>) {
+                if (g.first >= trial_prime_count) {
+                    break;
+                }
+                const std::uint64_t m = limb_mod_small(x._data.data(), n, g.product);
+                for (std::size_t i = g.first; i < g.last; ++i) {
+                    if (m % small_primes[i] == 0) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // the jacobi symbol (a/m) for odd m
+        constexpr int word_jacobi(std::uint64_t a, std::uint64_t m) noexcept {
+            int j = 1;
+            a %= m;
+            while (a != 0) {
+                const int t = std::countr_zero(a);
+                a >>= t;
+                if ((t & 1) && ((m & 7) == 3 || (m & 7) == 5)) {
+                    j = -j;
+                }
+                if ((a & 3) == 3 && (m & 3) == 3) {
+                    j = -j;
+                }
+                std::swap(a, m);
+                a %= m;
+            }
+            return m == 1 ? j : 0;
+        }
+
+        // the unsigned limb type primes of Int are tested in, Extra spare bits on top
+        template<class Int, std::size_t Extra = 0>
+        struct prime_type_impl {
+            using type = integer<int_bits_v<Int> + Extra, std::uint64_t, void, false>;
+        };
+
+        template<class Int, std::size_t Extra>
+        requires is_integer_v<Int>
+        struct prime_type_impl<Int, Extra> {
+            using type = integer<Int::size() + Extra, typename montgomery_context<Int>::word_type, void, false>;
+        };
+
+        template<class Int, std::size_t Extra = 0>
+        using prime_type = typename prime_type_impl<Int, Extra>::type;
+
+        // x / 2 mod m for x in montgomery form, the limbs above those of m are zero
+        template<class U>
+        U mont_half(const montgomery_context<U>& ctx, const U& x) noexcept {
+            constexpr std::size_t n = U::array_size;
+            U r = x;
+            typename U::word_type carry = 0;
+            if (r._data[0] & 1) {
+                carry = limb_add_n(r._data.data(), r._data.data(), ctx._m._data.data(), n);
+            }
+            limb_rshift(r._data.data(), r._data.data(), n, 1, carry);
+            return r;
+        }
+
+        // strong probable prime to base a, n odd and above 2
+        template<class U>
+        bool int_miller_rabin(const montgomery_context<U>& ctx, const U& n, const U& a) {
+            const U n1 = n - 1;
+            const std::size_t s = n1.countr_zero();
+            const U minus_one = ctx.sub(U(0), ctx.one());
+            U y = ctx.pow(ctx.to_mont(a), n1 >> s);
+            if (y == ctx.one() || y == minus_one) {
+                return true;
+            }
+            for (std::size_t i = 1; i < s; ++i) {
+                y = ctx.sqr(y);
+                if (y == minus_one) {
+                    return true;
+                }
+                if (y == ctx.one()) {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        // strong lucas probable prime with P = 1 and Q = (1 - D) / 4 for the first D of
+        // 5, -7, 9, -11, .. with (D/n) = -1 (selfridge), n odd, above 2 and not a square
+        template<class U>
+        bool int_strong_lucas(const montgomery_context<U>& ctx, const U& n) {
+            const std::size_t nn = limb_trim(n._data.data(), U::array_size);
+            const std::uint64_t n4 = int_low_u64(n) & 3;
+            std::int64_t d = 5;
+            for (;; d = d > 0 ? -d - 2 : -d + 2) {
+                const std::uint64_t ad = d < 0 ? -d : d;
+                // (D/n) = (-1/n)^[D < 0] (n/|D|) by reciprocity
+                int j = word_jacobi(limb_mod_small(n._data.data(), nn, ad), ad);
+                if ((d < 0 && n4 == 3) != ((ad & 3) == 3 && n4 == 3)) {
+                    j = -j;
+                }
+                if (j == -1) {
+                    break;
+                }
+                if (j == 0) {
+                    return n == ad;
+                }
+            }
+            auto small = [&ctx](std::int64_t v) {
+                const U r = ctx.to_mont(U(static_cast<std::uint64_t>(v < 0 ? -v : v)));
+                return v < 0 ? ctx.sub(U(0), r) : r;
+            };
+            const U one = small(1), md = small(d), mq = small((1 - d) / 4);
+
+            // n + 1 = e * 2^s, where n + 1 wraps only for n = 2^bits - 1
+            const U k = n + 1;
+            const std::size_t s = k == 0 ? U::size() : k.countr_zero();
+            const U e = k == 0 ? U(1) : k >> s;
+
+            // U_k, V_k and Q^k left to right over e, starting from k = 1
+            U uk = one, vk = one, qk = mq;
+            for (std::size_t i = e.bit_width() - 1; i-- > 0;) {
+                uk = ctx.mul(uk, vk);
+                vk = ctx.sub(ctx.sqr(vk), ctx.add(qk, qk));
+                qk = ctx.sqr(qk);
+                if (e[i]) {
+                    const U u1 = mont_half(ctx, ctx.add(uk, vk));
+                    vk = mont_half(ctx, ctx.add(ctx.mul(md, uk), vk));
+                    uk = u1;
+                    qk = ctx.mul(qk, mq);
+                }
+            }
+            if (!uk || !vk) {
+                return true;
+            }
+            for (std::size_t r = 1; r < s; ++r) {
+                vk = ctx.sub(ctx.sqr(vk), ctx.add(qk, qk));
+                if (!vk) {
+                    return true;
+                }
+                qk = ctx.sqr(qk);
+            }
+            return false;
+        }
+
+        // baillie-psw plus rounds of miller-rabin to fixed pseudo random bases, for odd n
+        // above small_prime_bound that no small prime divides
+        template<class U>
+        bool int_bpsw(const U& n, std::size_t rounds) {
+            const montgomery_context<U> ctx(n);
+            if (!int_miller_rabin(ctx, n, U(2)) || is_perfect_square(n) || !int_strong_lucas(ctx, n)) {
+                return false;
+            }
+            const bool narrow = n.bit_width() <= 64;
+            std::uint64_t h = 0x9e3779b97f4a7c15;
+            for (std::size_t i = 0; i < rounds; ++i) {
+                // splitmix64
+                std::uint64_t z = (h += 0x9e3779b97f4a7c15);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+                z ^= z >> 31;
+                const U a = narrow ? U(2 + z % (int_low_u64(n) - 3)) : U(z | 2);
+                if (!int_miller_rabin(ctx, n, a)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template<class U>
+        bool int_is_probable_prime(const U& n, std::size_t rounds) {
+            if (n < small_prime_bound) {
+                const std::uint64_t v = int_low_u64(n);
+                return v == 2 || std::binary_search(small_primes.begin(), small_primes.end(), v);
+            }
+            if ((n._data[0] & 1) == 0 || int_has_small_factor(n)) {
+                return false;
+            }
+            return int_bpsw(n, rounds);
+        }
+    }
+
+    // whether x is a probable prime, baillie-psw followed by rounds more miller-rabin
+    // tests to pseudo random bases. exact below 2^64
+    template<class Int>
+    requires is_integer_v<Int> || std::is_integral_v<Int>
+    bool is_probable_prime(const Int& x, std::size_t rounds = 0) {
+        if (x < 2) {
+            return false;
+        }
+        return details::int_is_probable_prime(details::prime_type<Int>(x), rounds);
+    }
+
+    // the least probable prime above x. odd candidates are sieved by the small primes
+    // a window at a time, the survivors may be tested on several threads
+    template<class Int>
+    requires is_integer_v<Int> || std::is_integral_v<Int>
+    Int next_prime(const Int& x, std::size_t threads = 1) {
+        using U = details::prime_type<Int, 1>;
+        constexpr std::size_t max_bits = details::int_bits_v<Int> - [] {
+            if constexpr (is_integer_v<Int>) {
+                return Int::is_signed_v;
+            } else {
+                return std::is_signed_v<Int>;
+            }
+        }();
+        if (x < 2) {
+            return Int(2);
+        }
+        U start = U(x) + 1;
+        if (!start[0]) {
+            start += 1;
+        }
+        if (start < details::small_prime_bound) {
+            const auto p = std::lower_bound(details::small_primes.begin(), details::small_primes.end(), details::int_low_u64(start));
+            if (p != details::small_primes.end()) {
+                return Int(*p);
+            }
+            start = details::small_prime_bound + 1;
+        }
+
+        // sieving by p pays while a residue costs less than the tests it saves, primes
+        // up to bits^2 keep the sieve well under the cost of one test
+        const std::size_t bits = start.bit_width();
+        const std::size_t len = std::max<std::size_t>(64, 4 * bits);
+        const std::size_t count = std::lower_bound(details::small_primes.begin(), details::small_primes.end(),
+                                                   std::clamp<std::size_t>(bits * bits, 4096, details::small_prime_bound)) - details::small_primes.begin();
+        std::vector<std::uint32_t> residues(details::small_prime_count);
+        std::vector<char> composite(len);
+        std::vector<std::size_t> survivors;
+        for (;; start += 2 * len) {
+            if (start.bit_width() > max_bits) {
+                throw std::runtime_error("next_prime does not fit the integer type");
+            }
+            // composite[i] for start + 2i, with r = start mod p the first multiple of p
+            // is at i = (p - r) / 2 for odd r and at p - r / 2 for even r
+            details::int_small_residues(start, residues.data(), count);
+            std::fill(composite.begin(), composite.end(), 0);
+            for (std::size_t j = 0; j < count; ++j) {
+                const std::size_t p = details::small_primes[j], r = residues[j];
+                for (std::size_t i = r == 0 ? 0 : (r & 1) ? (p - r) / 2 : p - r / 2; i < len; i += p) {
+                    composite[i] = 1;
+                }
+            }
+            survivors.clear();
+            for (std::size_t i = 0; i < len; ++i) {
+                if (!composite[i]) {
+                    survivors.push_back(i);
+                }
+            }
+
+            std::atomic<std::size_t> next = 0, found = survivors.size();
+            auto work = [&] {
+                for (std::size_t i; (i = next++) < found.load();) {
+                    if (details::int_bpsw(U(start + 2 * survivors[i]), 0)) {
+                        // candidates are handed out in order, so all before i are taken
+                        std::size_t cur = found.load();
+                        while (i < cur && !found.compare_exchange_weak(cur, i)) {}
+                        return;
+                    }
+                }
+            };
+            std::vector<std::thread> pool;
+            for (std::size_t t = 1; t < std::min(threads, survivors.size()); ++t) {
+                pool.emplace_back(work);
+            }
+            work();
+            for (auto& t : pool) {
+                t.join();
+            }
+            if (found < survivors.size()) {
+                const U p = start + 2 * survivors[found];
+                if (p.bit_width() > max_bits) {
+                    throw std::runtime_error("next_prime does not fit the integer type");
+                }
+                return Int(p);
+            }
+        }
+    }
+}
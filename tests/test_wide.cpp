@@ -0,0 +1,1193 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <charconv>
+#include <format>
+#include <random>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "log.h"
+#include "integer.h"
+#include "montgomery.h"
+#include "modint.h"
+#include "fraction.h"
+#include "ndarray.h"
+#include "allocator.h"
+#include "integer_expr.h"
+#include "prime.h"
+#include "bigint.h"
+
+// word-level paths: operands share a word type, so every operator takes the limb kernels
+
+std::mt19937_64 rand_engine(19519);
+
+template<class Int>
+Int random_integer(std::size_t bits = Int::size()) {
+    Int res = 0;
+    for (std::size_t i = 0; i < bits; i += 32) {
+        res <<= 32;
+        res += Int(static_cast<std::uint32_t>(rand_engine()));
+    }
+    if (bits % 32 != 0) {
+        res >>= 32 - bits % 32;
+    }
+    return res;
+}
+
+template<class Word>
+bool check_native(int n) {
+    exlib::nints<64, Word> a, b;
+    exlib::unints<64, Word> ua, ub;
+    for (int i = 0; i < n; ++i) {
+        // small, single word and full width divisors
+        std::uint64_t x = rand_engine();
+        std::uint64_t y = rand_engine() >> (rand_engine() % 64);
+        if (y == 0) y = 7;
+        // the reference wraps in uint64, and INT64_MIN / -1 has no int64 result at all
+        const std::uint64_t uy = (i & 1) ? 0 - y : y;
+        if (uy == ~std::uint64_t(0) && x == std::uint64_t(1) << 63) x += 1;
+        std::int64_t sx = static_cast<std::int64_t>(x);
+        std::int64_t sy = static_cast<std::int64_t>(uy);
+        a = sx, b = sy, ua = x, ub = y;
+
+        if (!(a + b == static_cast<std::int64_t>(x + uy) && a - b == static_cast<std::int64_t>(x - uy) && a * b == static_cast<std::int64_t>(x * uy))) {
+            exlib::log_fatal("fatal +-* at {}, {}", sx, sy);
+            return false;
+        }
+        if (!(a / b == sx / sy && a % b == sx % sy)) {
+            exlib::log_fatal("fatal signed / % at {}, {}: {}, {}", sx, sy, (a / b).str(), (a % b).str());
+            return false;
+        }
+        if (!(ua / ub == x / y && ua % ub == x % y)) {
+            exlib::log_fatal("fatal unsigned / % at {}, {}", x, y);
+            return false;
+        }
+        int k = static_cast<int>(rand_engine() % 64);
+        if (!((a << k) == static_cast<std::int64_t>(x << k) && (a >> k) == (sx >> k) && (ua >> k) == (x >> k))) {
+            exlib::log_fatal("fatal shift at {}, {}", sx, k);
+            return false;
+        }
+        ua /= ub;
+        a %= b;
+        if (!(ua == x / y && a == sx % sy)) {
+            exlib::log_fatal("fatal /= %= at {}, {}", x, y);
+            return false;
+        }
+    }
+    return true;
+}
+
+// widths that leave padding above N in the top word against int64 wrapped to N bits,
+// with the sign bit written through bit references as well as by arithmetic
+template<std::size_t N, class Word>
+bool check_odd_width(int n) {
+    using type = exlib::nints<N, Word>;
+    using wide = exlib::nints<96, Word>;
+    constexpr int shift = 64 - N;
+    auto wrap = [](std::uint64_t v) { return static_cast<std::int64_t>(v << shift) >> shift; };
+    for (int i = 0; i < n; ++i) {
+        std::int64_t x = wrap(rand_engine());
+        std::int64_t y = wrap(rand_engine() >> (rand_engine() % 64));
+        type a = x, b = y;
+        const std::size_t k = rand_engine() % N;
+        const bool v = rand_engine() & 1, s = rand_engine() & 1;
+        a[k] = v;
+        x = wrap(v ? x | (std::int64_t(1) << k) : x & ~(std::int64_t(1) << k));
+        a[N - 1] = b[rand_engine() % N] = s;
+        x = wrap(s ? x | (std::int64_t(1) << (N - 1)) : x & ~(std::int64_t(1) << (N - 1)));
+        b[N - 1].flip();
+        y = static_cast<std::int64_t>(b);
+        if (y == 0) {
+            b = 5, y = 5;
+        }
+
+        if (!(a == type(x) && b == wide(y) && static_cast<std::int64_t>(a) == x && wide(a) == x && a.sign() == (x < 0) && (a < b) == (x < y))) {
+            exlib::log_fatal("fatal bit write at {} bits: {}", N, x);
+            return false;
+        }
+        const std::uint64_t ux = static_cast<std::uint64_t>(x), uy = static_cast<std::uint64_t>(y);
+        if (!(a + b == wrap(ux + uy) && a - b == wrap(ux - uy) && a * b == wrap(ux * uy) && a / b == wrap(static_cast<std::uint64_t>(x / y))
+           && a % b == x % y && (a << 3) == wrap(ux << 3) && (a >> 3) == (x >> 3) && (a ^ b) == (x ^ y))) {
+            exlib::log_fatal("fatal ops at {} bits: {}, {}", N, x, y);
+            return false;
+        }
+    }
+    return true;
+}
+
+// add/sub kernels against carries summed in 64 bits over 16-bit limbs, and the same
+// limbs packed four to a word for the 64-bit kernels
+template<class Word>
+std::vector<Word> pack_limbs(const std::vector<std::uint16_t>& a) {
+    constexpr std::size_t per = sizeof(Word) / 2;
+    std::vector<Word> r(a.size() / per);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        r[i / per] |= static_cast<Word>(static_cast<Word>(a[i]) << (16 * (i % per)));
+    }
+    return r;
+}
+
+std::vector<std::uint16_t> random_limbs(std::size_t n, bool ones) {
+    std::vector<std::uint16_t> a(n);
+    for (auto& w : a) w = ones ? 0xffff : static_cast<std::uint16_t>(rand_engine());
+    return a;
+}
+
+bool check_add_kernels(int n) {
+    using namespace exlib::details;
+    for (int i = 0; i < n; ++i) {
+        const std::size_t an = 4 * (1 + rand_engine() % 20), bn = 4 * (1 + rand_engine() % (an / 4));
+        const auto a = random_limbs(an, i % 3 == 1), b = random_limbs(bn, i % 3 == 2);
+        std::vector<std::uint16_t> sum(an), diff(an);
+        std::int64_t carry = 0, borrow = 0;
+        for (std::size_t k = 0; k < an; ++k) {
+            const std::int64_t bk = k < bn ? b[k] : 0;
+            const std::int64_t t = a[k] + bk + carry, d = a[k] - bk - borrow;
+            sum[k] = static_cast<std::uint16_t>(t);
+            diff[k] = static_cast<std::uint16_t>(d);
+            carry = t >> 16;
+            borrow = d < 0;
+        }
+
+        std::vector<std::uint16_t> r16(an), s16(an);
+        const bool ok16 = limb_add(r16.data(), a.data(), an, b.data(), bn) == carry && r16 == sum
+                       && limb_sub(s16.data(), a.data(), an, b.data(), bn) == borrow && s16 == diff;
+        const auto a64 = pack_limbs<std::uint64_t>(a), b64 = pack_limbs<std::uint64_t>(b);
+        std::vector<std::uint64_t> r64(an / 4), s64(an / 4);
+        const bool ok64 = limb_add(r64.data(), a64.data(), an / 4, b64.data(), bn / 4) == std::uint64_t(carry) && r64 == pack_limbs<std::uint64_t>(sum)
+                       && limb_sub(s64.data(), a64.data(), an / 4, b64.data(), bn / 4) == std::uint64_t(borrow) && s64 == pack_limbs<std::uint64_t>(diff);
+        if (!(ok16 && ok64)) {
+            exlib::log_fatal("fatal add/sub kernels at {} + {} limbs", an, bn);
+            return false;
+        }
+    }
+    return true;
+}
+
+// schoolbook kernels against column sums, the truncated product against the low limbs
+template<class Word>
+bool mul_kernels_match(const std::vector<std::uint16_t>& a, const std::vector<std::uint16_t>& b, const std::vector<std::uint16_t>& prod, std::size_t low) {
+    using namespace exlib::details;
+    constexpr std::size_t per = sizeof(Word) / 2;
+    const auto pa = pack_limbs<Word>(a), pb = pack_limbs<Word>(b), expect = pack_limbs<Word>(prod);
+    const std::size_t an = pa.size(), bn = pb.size();
+    std::vector<Word> r(an + bn), sq(2 * an), lo(low / per);
+    limb_mul_basecase(r.data(), pa.data(), an, pb.data(), bn);
+    limb_sqr_basecase(sq.data(), pa.data(), an);
+    limb_mul_low(lo.data(), lo.size(), pa.data(), an, pb.data(), bn);
+    std::vector<Word> sq_ref(2 * an);
+    limb_mul_basecase(sq_ref.data(), pa.data(), an, pa.data(), an);
+    return r == expect && sq == sq_ref && std::equal(lo.begin(), lo.end(), expect.begin());
+}
+
+bool check_mul_kernels(int n) {
+    for (int i = 0; i < n; ++i) {
+        const std::size_t an = 4 * (1 + rand_engine() % 20), bn = 4 * (1 + rand_engine() % 20);
+        const auto a = random_limbs(an, i % 3 == 1), b = random_limbs(bn, i % 3 != 0);
+        std::vector<std::uint16_t> prod(an + bn);
+        std::uint64_t acc = 0;
+        for (std::size_t k = 0; k < an + bn; ++k) {
+            for (std::size_t j = k < bn ? 0 : k - bn + 1; j <= k && j < an; ++j) {
+                acc += std::uint64_t(a[j]) * b[k - j];
+            }
+            prod[k] = static_cast<std::uint16_t>(acc);
+            acc >>= 16;
+        }
+        const std::size_t low = 4 * (rand_engine() % ((an + bn) / 4 + 1));
+        if (!(mul_kernels_match<std::uint16_t>(a, b, prod, low) && mul_kernels_match<std::uint32_t>(a, b, prod, low)
+           && mul_kernels_match<std::uint64_t>(a, b, prod, low))) {
+            exlib::log_fatal("fatal mul kernels at {} x {} limbs", an, bn);
+            return false;
+        }
+    }
+    return true;
+}
+
+template<std::size_t N, class Word>
+bool check_divmod(int n) {
+    using wide = exlib::nints<N, Word>;
+    for (int i = 0; i < n; ++i) {
+        std::size_t abits = N / 2 - 1 - rand_engine() % (N / 4);
+        std::size_t bbits = 1 + rand_engine() % (N / 2 - 1);
+        wide a = random_integer<wide>(abits);
+        wide b = random_integer<wide>(bbits);
+        if (b == 0) b = 1;
+        if (i & 1) a = -a;
+        if (i & 2) b = -b;
+
+        wide q = a / b;
+        wide r = a % b;
+        if (!(q * b + r == a && r.abs() < b.abs() && (r == 0 || r.sign() == a.sign()))) {
+            exlib::log_fatal("fatal divmod at {} bits: {} / {}", N, a.str(), b.str());
+            return false;
+        }
+        if (!((a * b) / b == a && (a * b) % b == 0)) {
+            exlib::log_fatal("fatal (a * b) / b at {} bits: {}, {}", N, a.str(), b.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+template<std::size_t N, class Word>
+bool check_divmod_api(int n) {
+    using wide = exlib::nints<N, Word>;
+    for (int i = 0; i < n; ++i) {
+        wide a = random_integer<wide>(N - 1 - rand_engine() % (N / 2));
+        wide b = random_integer<wide>(1 + rand_engine() % (N / 2 - 1));
+        if (b == 0) b = 3;
+        if (i & 1) a = -a;
+        if (i & 2) b = -b;
+
+        auto [q, r] = exlib::divmod(a, b);
+        if (!(q == a / b && r == a % b)) {
+            exlib::log_fatal("fatal divmod api at {} bits: {} / {}", N, a.str(), b.str());
+            return false;
+        }
+
+        Word d = static_cast<Word>((static_cast<Word>(rand_engine()) >> 1) | 1);
+        wide x = a;
+        Word rem = x.div_small(d);
+        wide w = wide(d);
+        if (!(x == a / w && wide(rem) == (a % w).abs())) {
+            exlib::log_fatal("fatal div_small at {} bits: {} / {}", N, a.str(), static_cast<std::uint64_t>(d));
+            return false;
+        }
+
+        wide h = a >> (N / 2);
+        wide g = exlib::gcd(h * b, b * b);
+        if (!(g.abs() == b.abs() * exlib::gcd(h, b).abs())) {
+            exlib::log_fatal("fatal gcd at {} bits: {}, {}", N, a.str(), b.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// operands of different word types, compared and combined after repacking
+template<class W1, class W2>
+bool check_mixed(int n) {
+    for (int i = 0; i < n; ++i) {
+        std::int64_t x = static_cast<std::int64_t>(rand_engine()) >> (rand_engine() % 64);
+        std::int64_t y = (i & 1) ? x + static_cast<std::int64_t>(rand_engine() % 3) - 1 : static_cast<std::int64_t>(rand_engine());
+        exlib::nints<64, W1> a = x;
+        exlib::nints<96, W2> b = y;
+        exlib::nints<64, W2> c = a;
+        if (!(c == x && (a == b) == (x == y) && (a < b) == (x < y) && (a > b) == (x > y) && (x < b) == (x < y))) {
+            exlib::log_fatal("fatal mixed compare at {}, {}", x, y);
+            return false;
+        }
+        if (!((a & b) == (x & y) && (a | b) == (x | y) && (a ^ b) == (x ^ y))) {
+            exlib::log_fatal("fatal mixed bitwise at {}, {}", x, y);
+            return false;
+        }
+        a ^= b;
+        if (!(a == (x ^ y))) {
+            exlib::log_fatal("fatal mixed ^= at {}, {}", x, y);
+            return false;
+        }
+    }
+    return true;
+}
+
+// barrett against schoolbook division, thresholds lowered so small operands take the newton path
+template<class Word>
+bool check_barrett(int n) {
+    using namespace exlib::details;
+    const div_thresholds small = {4, 4};
+    for (int i = 0; i < n; ++i) {
+        std::size_t dn = 2 + rand_engine() % 80;
+        std::size_t an = dn + rand_engine() % 200;
+        std::vector<Word> a(an), d(dn);
+        for (auto& w : a) w = static_cast<Word>(rand_engine());
+        for (auto& w : d) w = static_cast<Word>(rand_engine());
+        d[dn - 1] |= static_cast<Word>(1) << (rand_engine() % limb_bits<Word>);
+        if (i & 1) std::fill(d.begin(), d.end() - 1, static_cast<Word>(~static_cast<Word>(0)));
+
+        std::vector<Word> q1(an - dn + 1), r1(dn), q2(an - dn + 1), r2(dn);
+        std::vector<Word> scratch(limb_div_qr_scratch_size(an, dn));
+        limb_div_qr_basecase(q1.data(), r1.data(), a.data(), an, d.data(), dn, scratch.data());
+        limb_div_qr_barrett(q2.data(), r2.data(), a.data(), an, d.data(), dn, small);
+        if (q1 != q2 || r1 != r2) {
+            exlib::log_fatal("fatal barrett at {} / {} limbs", an, dn);
+            return false;
+        }
+    }
+    return true;
+}
+
+// a * b through limb_mul with thresholds th against the schoolbook product
+template<class Word>
+bool mul_matches(const std::vector<Word>& a, const std::vector<Word>& b, const exlib::details::mul_thresholds& th) {
+    using namespace exlib::details;
+    const std::size_t an = a.size(), bn = b.size();
+    std::vector<Word> expect(an + bn), r(an + bn);
+    std::vector<Word> scratch(limb_mul_scratch_size(an, bn, th) + 1);
+    if (an >= bn) limb_mul_basecase(expect.data(), a.data(), an, b.data(), bn);
+    else limb_mul_basecase(expect.data(), b.data(), bn, a.data(), an);
+    limb_mul(r.data(), a.data(), an, b.data(), bn, scratch.data(), th);
+    if (r != expect) return false;
+    if (an == bn) {
+        limb_mul_n(r.data(), a.data(), b.data(), an, scratch.data(), th);
+        if (r != expect) return false;
+    }
+    return true;
+}
+
+template<class Word>
+std::vector<Word> random_words(std::size_t n, bool ones) {
+    std::vector<Word> a(n);
+    for (auto& w : a) w = ones ? static_cast<Word>(~static_cast<Word>(0)) : static_cast<Word>(rand_engine());
+    return a;
+}
+
+// karatsuba and toom-3 against schoolbook, thresholds lowered so small operands recurse
+// through both tiers, balanced, squared and unbalanced
+template<class Word>
+bool check_toom(int n) {
+    using namespace exlib::details;
+    constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+    const mul_thresholds karatsuba = {4, inf, EXLIB_MUL_FULL_PRODUCT_THRESHOLD, inf};
+    const mul_thresholds toom3 = {4, 9, EXLIB_MUL_FULL_PRODUCT_THRESHOLD, inf};
+    for (int i = 0; i < n; ++i) {
+        const std::size_t an = 1 + rand_engine() % 300;
+        const std::size_t bn = (i % 4 == 0) ? an : 1 + rand_engine() % 300;
+        const auto a = random_words<Word>(an, i % 3 == 1), b = random_words<Word>(bn, i % 3 == 2);
+        if (!(mul_matches(a, b, karatsuba) && mul_matches(a, b, toom3) && mul_matches(a, a, toom3))) {
+            exlib::log_fatal("fatal toom-3 at {} x {} limbs", an, bn);
+            return false;
+        }
+    }
+    return true;
+}
+
+// the ntt tier against schoolbook with the threshold lowered to 16 limbs: random sizes,
+// transform lengths either side of each power of two, and an operand past ntt_max_length
+// chunks that must fall back to pieces the size of the shorter one
+template<class Word>
+bool check_ntt(int n) {
+    using namespace exlib::details;
+    const mul_thresholds th = {4, 9, EXLIB_MUL_FULL_PRODUCT_THRESHOLD, 16};
+    for (int i = 0; i < n; ++i) {
+        const std::size_t an = 16 + rand_engine() % 700;
+        const std::size_t bn = (i % 4 == 0) ? an : 16 + rand_engine() % 700;
+        const auto a = random_words<Word>(an, i % 3 == 1), b = random_words<Word>(bn, i % 3 == 2);
+        if (!(mul_matches(a, b, th) && mul_matches(a, a, th))) {
+            exlib::log_fatal("fatal ntt at {} x {} limbs", an, bn);
+            return false;
+        }
+    }
+
+    for (std::size_t k = 6; k <= 12; ++k) {
+        const std::size_t length = std::size_t(1) << k;
+        for (std::size_t bn : {std::size_t(20), length / 4}) {
+            for (std::size_t an = bn;; ++an) {
+                const std::size_t terms = ntt_chunks<Word>(an) + ntt_chunks<Word>(bn) - 1;
+                if (terms > length + 1) break;
+                if (terms + 1 < length) continue;
+                const auto a = random_words<Word>(an, an % 2 == 0), b = random_words<Word>(bn, true);
+                if (!(mul_matches(a, b, th) && (an != bn || mul_matches(a, a, th)))) {
+                    exlib::log_fatal("fatal ntt at {} x {} limbs, length {}", an, bn, length);
+                    return false;
+                }
+            }
+        }
+    }
+
+    // 2^19 pieces, once for the widest word
+    const std::size_t big = ntt_max_length / ntt_chunks<Word>(1), small = 16;
+    if (!(ntt_fits<Word>(big - small, small) && !ntt_fits<Word>(big, small)
+       && (sizeof(Word) < 8 || mul_matches(random_words<Word>(big, false), random_words<Word>(small, false), th)))) {
+        exlib::log_fatal("fatal ntt fallback at {} x {} limbs", big, small);
+        return false;
+    }
+    return true;
+}
+
+bool check_str() {
+    std::int64_t values[] = {0, 1, -1, 9, 10, -10, 1000000000, 999999999, 10000000000000000000ull / 3,
+                             std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::min()};
+    for (std::int64_t v : values) {
+        if (exlib::nints<64, std::uint8_t>(v).str() != std::to_string(v)
+         || exlib::nints<64, std::uint32_t>(v).str() != std::to_string(v)
+         || exlib::nints<64, std::uint64_t>(v).str() != std::to_string(v)) {
+            exlib::log_fatal("fatal str at {}: {}", v, exlib::nints<64, std::uint32_t>(v).str());
+            return false;
+        }
+    }
+    exlib::unints<256, std::uint64_t> x = 1;
+    std::string expected = "1";
+    for (int i = 0; i < 70; ++i) {
+        x *= 10;
+        expected.push_back('0');
+        if (x.str() != expected) {
+            exlib::log_fatal("fatal str at 10^{}: {}", i + 1, x.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// divide and conquer output against one limb division at a time, and at 10^e - 1 and 10^e
+// around the cached power boundaries
+template<class Word>
+bool check_str_dc(int n) {
+    using namespace exlib::details;
+    for (int i = 0; i < n; ++i) {
+        std::size_t len = str_dc_threshold + rand_engine() % 400;
+        std::vector<Word> a(len), b(len);
+        for (auto& w : a) w = static_cast<Word>(rand_engine());
+        a[len - 1] >>= rand_engine() % limb_bits<Word>;
+        b = a;
+        std::string expected(len * limb_bits<Word>, '0');
+        limb_to_decimal_basecase(expected.data(), expected.size(), b.data(), len);
+        expected.erase(0, expected.find_first_not_of('0'));
+        if (limb_to_decimal(a.data(), len) != expected) {
+            exlib::log_fatal("fatal str at {} limbs", len);
+            return false;
+        }
+    }
+
+    exlib::unints<16384, Word> x = 1;
+    for (std::size_t e = 1; e <= 4000; ++e) {
+        x *= 10;
+        if (e % 19 > 1 && e % 64 > 1) continue;
+        if (x.str() != "1" + std::string(e, '0') || (x - 1).str() != std::string(e, '9')) {
+            exlib::log_fatal("fatal str at 10^{}", e);
+            return false;
+        }
+    }
+    return true;
+}
+
+// str() and rd_string / from_chars round trip, with the checked parse at the range limits
+template<std::size_t N, class Word>
+bool check_rd_string(int n) {
+    using wide = exlib::nints<N, Word>;
+    using uwide = exlib::unints<N, Word>;
+    for (int i = 0; i < n; ++i) {
+        wide a = random_integer<wide>(1 + rand_engine() % (N - 1));
+        if (i & 1) a = -a;
+        std::string s = a.str();
+        wide b, c;
+        b.rd_string(s);
+        std::string t = s + "x1";
+        auto [ptr, ec] = exlib::from_chars(t.data(), t.data() + t.size(), c);
+        if (!(b == a && c == a && ec == std::errc{} && ptr == t.data() + s.size())) {
+            exlib::log_fatal("fatal rd_string at {} bits: {}", N, s);
+            return false;
+        }
+    }
+
+    // the limits parse, one past them is out of range and wraps in rd_string
+    wide max = ~(wide(1) << (N - 1));
+    wide min = wide(1) << (N - 1);
+    uwide umax = ~uwide(0);
+    std::string over = (uwide(max) + uwide(1)).str();
+    std::string uover = umax.str();
+    uover.back() += 1;
+    wide x;
+    uwide ux;
+    std::string s = max.str();
+    bool ok = exlib::from_chars(s.data(), s.data() + s.size(), x).ec == std::errc{} && x == max;
+    s = min.str();
+    ok = ok && exlib::from_chars(s.data(), s.data() + s.size(), x).ec == std::errc{} && x == min;
+    s = umax.str();
+    ok = ok && exlib::from_chars(s.data(), s.data() + s.size(), ux).ec == std::errc{} && ux == umax;
+    ok = ok && exlib::from_chars(over.data(), over.data() + over.size(), x).ec == std::errc::result_out_of_range && x == min;
+    ok = ok && exlib::from_chars(uover.data(), uover.data() + uover.size(), ux).ec == std::errc::result_out_of_range && ux == umax;
+    ok = ok && wide(over) == min && uwide(std::string_view(uover)) == uwide(0);
+    s = "-1";
+    ok = ok && exlib::from_chars(s.data(), s.data() + s.size(), ux).ec == std::errc::invalid_argument && ux == umax;
+    ok = ok && uwide(s) == umax;
+    s = "-x";
+    ok = ok && exlib::from_chars(s.data(), s.data() + s.size(), x).ec == std::errc::invalid_argument;
+    if (!ok) {
+        exlib::log_fatal("fatal from_chars limits at {} bits", N);
+    }
+    return ok;
+}
+
+// power of two bases against std::to_chars on 64-bit values, then round trips at full width
+template<class Word>
+bool check_radix(int n) {
+    char buf[80], ref[80];
+    for (int i = 0; i < n; ++i) {
+        std::int64_t x = static_cast<std::int64_t>(rand_engine()) >> (rand_engine() % 64);
+        exlib::nints<64, Word> a = x;
+        for (int base : {2, 8, 10, 16}) {
+            auto [p, ec] = exlib::to_chars(buf, buf + sizeof(buf), a, base);
+            auto [q, rec] = std::to_chars(ref, ref + sizeof(ref), x, base);
+            exlib::nints<64, Word> b;
+            if (!(ec == std::errc{} && std::string(buf, p) == std::string(ref, q)
+               && exlib::from_chars(buf, p, b, base).ec == std::errc{} && b == a)) {
+                exlib::log_fatal("fatal base {} at {}: {}", base, x, std::string(buf, p));
+                return false;
+            }
+        }
+        if (!(std::format("{:x}", a) == a.str(16) && std::format("{:b}", a) == a.str(2) && std::format("{}", a) == a.str())) {
+            exlib::log_fatal("fatal format at {}", x);
+            return false;
+        }
+    }
+
+    exlib::unints<256, Word> u = random_integer<exlib::unints<256, Word>>();
+    std::string h = u.hex();
+    exlib::unints<256, Word> v;
+    if (!(h.size() == 64 && exlib::from_chars(h.data(), h.data() + h.size(), v, 16).ec == std::errc{} && v == u
+       && exlib::to_chars(buf, buf + 10, u, 16).ec == std::errc::value_too_large
+       && exlib::nints<12, Word>(-1).hex() == "fff" && exlib::nints<12, Word>(-1).bin() == "111111111111")) {
+        exlib::log_fatal("fatal hex at {}", h);
+        return false;
+    }
+    return true;
+}
+
+// fill, align, sign, alternate form, zero padding and argument widths, bad specs throw
+bool check_format() {
+    const exlib::nints<64> a = 255, b = -255, z = 0;
+    const exlib::unints<100, std::uint8_t> u = 5;
+    int width = 6, negative = -1;
+    const bool ok = std::format("{:>8x}", a) == "      ff" && std::format("{:*<8}", u) == "5*******" && std::format("{:^7}", b) == " -255  "
+                 && std::format("{:+}", a) == "+255" && std::format("{: }", u) == " 5" && std::format("{:+x}", b) == "-ff"
+                 && std::format("{:#x}", a) == "0xff" && std::format("{:#X}", b) == "-0XFF" && std::format("{:#b}", u) == "0b101"
+                 && std::format("{:#B}", u) == "0B101" && std::format("{:#o}", a) == "0377" && std::format("{:#o}", z) == "0"
+                 && std::format("{:08x}", b) == "-00000ff" && std::format("{:#010x}", a) == "0x000000ff" && std::format("{:<06}", u) == "5     "
+                 && std::format("{:{}x}", a, width) == "    ff" && std::format("{0:_>{1}}", u, width) == "_____5" && std::format("{:3}", b) == "-255";
+    if (!ok) {
+        exlib::log_fatal("fatal format spec");
+        return false;
+    }
+    for (const char* spec : {"{:.3}", "{:xq}", "{:L}", "{:s}", "{:{}}"}) {
+        try {
+            (void)std::vformat(spec, std::make_format_args(a, negative));
+            exlib::log_fatal("fatal format spec {} accepted", spec);
+            return false;
+        } catch (const std::format_error&) {}
+    }
+    return true;
+}
+
+// montgomery arithmetic against double width products and %, then fermat on mersenne primes
+template<std::size_t N, class Word>
+bool check_montgomery(int n) {
+    using type = exlib::integer<N, Word, void, false>;
+    using wide = exlib::integer<2 * N, Word, void, false>;
+    for (int i = 0; i < n; ++i) {
+        type m = random_integer<type>(8 + rand_engine() % (N - 8)) | 1;
+        if (m == 1) m = 3;
+        const type a = random_integer<type>() % m, b = random_integer<type>() % m;
+        const type e = random_integer<type>(rand_engine() % 200);
+        exlib::montgomery_context<type> ctx(m);
+        auto am = ctx.to_mont(a), bm = ctx.to_mont(b);
+
+        wide p = 1, x = a;
+        for (type k = e; k != 0; k >>= 1) {
+            if ((k & 1) != 0) p = p * x % wide(m);
+            x = x * x % wide(m);
+        }
+        if (!(ctx.from_mont(ctx.mul(am, bm)) == type(wide(a) * wide(b) % wide(m))
+           && ctx.from_mont(ctx.sqr(am)) == type(wide(a) * wide(a) % wide(m))
+           && ctx.from_mont(ctx.add(am, bm)) == type((wide(a) + wide(b)) % wide(m))
+           && ctx.from_mont(ctx.sub(am, bm)) == type((wide(a) + wide(m) - wide(b)) % wide(m))
+           && ctx.powmod(a, e) == type(p) && exlib::powmod(a, e, m + 1) == type(wide(exlib::powmod(a, e, m + 1)) % wide(m + 1)))) {
+            exlib::log_fatal("fatal montgomery {} ^ {} mod {}", a.str(), e.str(), m.str());
+            return false;
+        }
+    }
+
+    for (std::size_t q : {61, 89, 127, 521}) {
+        if (q >= N) continue;
+        const type p = (type(1) << q) - 1;
+        const type a = random_integer<type>() % p;
+        if (exlib::powmod(a, p - 1, p) != 1 || exlib::powmod(type(3), p, p) != 3) {
+            exlib::log_fatal("fatal fermat mod 2^{} - 1", q);
+            return false;
+        }
+    }
+    return true;
+}
+
+// barrett modint against double width products and %, moduli of every size and parity
+template<std::size_t N, class Word>
+bool check_modint(int n) {
+    using type = exlib::integer<N, Word, void, false>;
+    using wide = exlib::integer<2 * N, Word, void, false>;
+    using mint = exlib::modint<type>;
+    for (int i = 0; i < n; ++i) {
+        type m = random_integer<type>(2 + rand_engine() % (N - 2));
+        if (m == 0) m = 1;
+        mint::set_mod(m);
+        const type a = random_integer<type>(), b = random_integer<type>();
+        const mint x(a), y(b);
+        const std::uint32_t e = static_cast<std::uint32_t>(rand_engine() % 100);
+        wide p = 1;
+        for (std::uint32_t k = 0; k < e; ++k) p = p * wide(a) % wide(m);
+        if (!((x * y).value() == type(wide(a) * wide(b) % wide(m))
+           && (x + y).value() == type((wide(a) % wide(m) + wide(b) % wide(m)) % wide(m))
+           && (x - y + y) == x && -x + x == mint(0) && mint(-1) + 1 == mint(0)
+           && x.pow(e).value() == type(p))) {
+            exlib::log_fatal("fatal modint {} * {} mod {}", a.str(), b.str(), m.str());
+            return false;
+        }
+    }
+
+    // as a dtype, modulo a prime so every nonzero element has an inverse
+    mint::set_mod((type(1) << 127) - 1);
+    exlib::fraction<mint> f(mint(1), mint(3)), g(mint(1), mint(4));
+    exlib::ndarray<exlib::shape<2, 3>, mint> arr;
+    arr.fill(mint(3));
+    arr = arr * mint(5) + arr;
+    auto h = f + g;
+    if (!(h.a / h.b == mint(7) / mint(12) && mint(12).inv() * 12 == mint(1) && arr[1][2] == mint(18))) {
+        exlib::log_fatal("fatal modint dtype {}", h.str());
+        return false;
+    }
+    return true;
+}
+
+// widening products and fused multiply-add against products in a type wide enough for both
+template<std::size_t K, std::size_t N, std::size_t M, class Word>
+bool check_fma(int n) {
+    using big = exlib::integer<K + N + M + 64, Word, void, true>;
+    for (int i = 0; i < n; ++i) {
+        auto acc = random_integer<exlib::integer<K, Word, void, true>>();
+        auto a = random_integer<exlib::integer<N, Word, void, true>>(rand_engine() % N + 1);
+        auto b = random_integer<exlib::integer<M, Word, void, false>>(rand_engine() % M + 1);
+        if (i & 1) a = -a;
+        const big ref = big(acc) + big(a) * big(b);
+        const auto w = exlib::mul_wide(a, b);
+        const decltype(acc) expect(ref);
+        if (!(std::is_same_v<std::decay_t<decltype(w)>, exlib::integer<N + M, Word, void, true>> && big(w) == big(a) * big(b)
+           && exlib::fma(acc, a, b) == expect)) {
+            exlib::log_fatal("fatal fma at {} {} {}", K, N, M);
+            return false;
+        }
+    }
+    return true;
+}
+
+// storage is inline up to EXLIB_INLINE_BITS by default, heap arrays hold exactly the words needed
+static_assert(std::is_void_v<exlib::nints<1024>::allocator_type> && !std::is_void_v<exlib::nints<65536>::allocator_type>);
+
+template<std::size_t N, class Word>
+bool check_storage(int n) {
+    using inline_type = exlib::integer<N, Word, void, true>;
+    using heap_type = exlib::integer<N, Word, std::allocator<Word>, true>;
+    for (int i = 0; i < n; ++i) {
+        auto a = random_integer<inline_type>(), b = random_integer<inline_type>(rand_engine() % N + 1);
+        heap_type ha = a, hb = b;
+        if (b == 0) continue;
+        if (!(heap_type()._data.size() == heap_type::array_size && inline_type(ha * hb) == a * b
+           && inline_type(ha / hb) == a / b && (ha - hb).str() == (a - b).str())) {
+            exlib::log_fatal("fatal storage {} {}", a.str(), b.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef __linux
+// counted by hook.cpp
+namespace zstl::_malloc_hook {
+    extern std::size_t allocations;
+}
+#endif
+
+// pooled and arena storage give the same values, and a repeated batch stops allocating
+template<std::size_t N, class Word>
+bool check_allocators(int n) {
+    using inline_type = exlib::integer<N, Word, void, true>;
+    using pool_type = exlib::integer<N, Word, exlib::pool_allocator<Word>, true>;
+    using arena_type = exlib::integer<N, Word, exlib::arena_allocator<Word>, true>;
+    std::vector<inline_type> xs;
+    for (int i = 0; i < n; ++i) {
+        xs.push_back(random_integer<inline_type>(rand_engine() % N + 1));
+    }
+    auto batch = [&xs]<class Int>(std::type_identity<Int>) {
+        Int acc = 1;
+        for (const auto& x : xs) {
+            Int y = x;
+            acc = acc * y + y / (acc | 1) - (y >> 3);
+        }
+        return inline_type(acc);
+    };
+    const inline_type ref = batch(std::type_identity<inline_type>());
+    std::size_t allocs = 0;
+    for (int round = 0; round < 3; ++round) {
+#ifdef __linux
+        const std::size_t before = zstl::_malloc_hook::allocations;
+#endif
+        exlib::arena_scope scope;
+        if (!(batch(std::type_identity<pool_type>()) == ref && batch(std::type_identity<arena_type>()) == ref)) {
+            exlib::log_fatal("fatal allocators at {}", N);
+            return false;
+        }
+#ifdef __linux
+        allocs = zstl::_malloc_hook::allocations - before;
+#endif
+    }
+
+    using arr = exlib::ndarray<exlib::shape<3, 4>, double, exlib::arena_allocator<double>>;
+    exlib::arena_scope scope;
+    arr a;
+    a.fill(2.0);
+    arr b = a * 3.0 + a;
+    if (!(allocs == 0 && b[2][3] == 8.0 && exlib::is_ndarray_v<arr>)) {
+        exlib::log_fatal("fatal allocators at {}, {} allocations", N, allocs);
+        return false;
+    }
+    return true;
+}
+
+// pooled values that outlive the thread's pool: a static, freed after the main thread's
+// thread locals, and a thread local constructed before the pool and so destroyed after it
+using pooled = exlib::integer<256, std::uint64_t, exlib::pool_allocator<std::uint64_t>, true>;
+const pooled static_pooled = 5;
+
+bool check_pool_teardown() {
+    static bool late_ok = false;
+    std::thread([] {
+        struct late {
+            std::optional<pooled> x;
+            ~late() {
+                pooled y = *x * 3;
+                late_ok = y == 15;
+            }
+        };
+        thread_local late l;
+        l.x.emplace(5);
+    }).join();
+    if (!(late_ok && static_pooled * 3 == 15)) {
+        exlib::log_fatal("fatal pool teardown");
+        return false;
+    }
+    return true;
+}
+
+// lazy expressions against the eager operators, including results that alias an operand
+template<class Int>
+bool check_expr(int n) {
+    using exlib::lazy;
+    for (int i = 0; i < n; ++i) {
+        const Int a = random_integer<Int>(), b = random_integer<Int>(), c = random_integer<Int>(), d = random_integer<Int>();
+        const Int r1 = lazy(a) * b + c - d;
+        const Int r2 = (lazy(a) + b) * (lazy(c) - d) - 7 + lazy(a) * b * c;
+        const Int r3 = 3 - lazy(a) - b + d * lazy(a);
+        Int r4 = a, r5 = a, r6 = a, r7 = a;
+        r4 = r4 + lazy(b) * c;
+        r5 = lazy(r5) * r5 - b;
+        r6 = b - lazy(r6) + r6;
+        exlib::fma(r7, r7, r7);
+        if (!(r1 == a * b + c - d && r2 == (a + b) * (c - d) - Int(7) + a * b * c && r3 == Int(3) - a - b + d * a
+           && r4 == a + b * c && r5 == a * a - b && r6 == b && r7 == a + a * a)) {
+            exlib::log_fatal("fatal expr {} {} {} {}", a.str(), b.str(), c.str(), d.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// roots bracketed by powers in a type wide enough for them, squares through the prefilter
+template<std::size_t N, class Word>
+bool check_roots(int n) {
+    using type = exlib::integer<N, Word, void, true>;
+    using big = exlib::integer<8 * N + 64, Word, void, true>;
+    for (int i = 0; i < n; ++i) {
+        type x = random_integer<type>(rand_engine() % (N - 1) + 1);
+        if (x < 0) x = type(-1) - x;
+        const std::size_t k = rand_engine() % 7 + 1;
+        const type r = exlib::isqrt(x), s = exlib::iroot(x, k), h = random_integer<type>((N - 2) / 2);
+        if (!(big(r) * big(r) <= big(x) && (big(r) + 1) * (big(r) + 1) > big(x)
+           && exlib::pow(big(s), k) <= big(x) && exlib::pow(big(s) + 1, k) > big(x)
+           && (k % 2 == 0 || exlib::iroot(type(0) - x, k) == type(0) - s)
+           && exlib::is_perfect_square(h * h) && (h < 2 || !exlib::is_perfect_square(h * h + 1))
+           && exlib::is_perfect_square(x) == (r * r == x))) {
+            exlib::log_fatal("fatal roots of {} at {}", x.str(), k);
+            return false;
+        }
+    }
+    return true;
+}
+
+// gcd against euclid on divmod, the bezout identity of xgcd, lcm and modinv
+template<std::size_t N, class Word>
+bool check_gcd(int n) {
+    using type = exlib::integer<N, Word, void, true>;
+    using big = exlib::integer<2 * N + 2, Word, void, true>;
+    for (int i = 0; i < n; ++i) {
+        const type h = random_integer<type>(rand_engine() % (N / 3) + 1);
+        type a = random_integer<type>(rand_engine() % (N / 3) + 1) * h, b = random_integer<type>(rand_engine() % (N / 3) + 1);
+        if (i % 3 != 0) b *= h;
+        if (i & 1) a = -a;
+        if (i & 2) b = -b;
+        if (i % 50 == 7) b = 0;
+        type x = a, y = b;
+        while (y != 0) {
+            x = std::exchange(y, x % y);
+        }
+        x = x.abs();
+        const auto [g, s, t] = exlib::xgcd(a, b);
+        bool ok = exlib::gcd(a, b) == x && g == x && big(a) * big(s) + big(b) * big(t) == big(g) && (b == 0 || s.abs() <= b.abs())
+               && (a == 0 || b == 0 || big(exlib::lcm(a, b)) * big(g) == (big(a) * big(b)).abs());
+        const type m = b.abs();
+        if (m > 1) {
+            try {
+                const type v = exlib::modinv(a, m);
+                ok = ok && g == 1 && v >= 0 && v < m && (big(v) * big(a) % big(m) + big(m)) % big(m) == 1;
+            } catch (const std::runtime_error&) {
+                ok = ok && g != 1;
+            }
+        }
+        if (!ok) {
+            exlib::log_fatal("fatal gcd of {} and {}", a.str(), b.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// bit scans against a walk over operator[], sparse and negative values included
+template<class Int>
+bool check_bits(int n) {
+    constexpr std::size_t N = Int::size();
+    for (int i = 0; i < n; ++i) {
+        Int x = random_integer<Int>(rand_engine() % N + 1);
+        if (i % 3 == 0) {
+            x = 0;
+            for (int k = rand_engine() % 4; k > 0; --k) x |= Int(1) << (rand_engine() % N);
+        }
+        if (i & 1) x = Int(0) - x;
+        std::vector<std::size_t> set, got;
+        for (std::size_t j = 0; j < N; ++j) {
+            if (x[j]) set.push_back(j);
+        }
+        for (std::size_t j : x.set_bits()) got.push_back(j);
+        const std::size_t p = rand_engine() % (N + 1);
+        const auto next = std::lower_bound(set.begin(), set.end(), p);
+        const std::size_t lz = set.empty() ? N : N - 1 - set.back();
+        if (!(x.popcount() == set.size() && x.countl_zero() == lz && x.bit_width() == N - lz
+           && x.countr_zero() == (set.empty() ? N : set[0]) && x.find_next(p) == (next == set.end() ? N : *next) && got == set)) {
+            exlib::log_fatal("fatal bit scans of {}", x.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// primality against a sieve, then pseudoprimes, mersenne numbers and prime gaps
+template<class Int>
+bool check_primes(int n) {
+    std::vector<bool> composite(n + 1);
+    Int last = 1;
+    for (int i = 2; i <= n; ++i) {
+        if (!composite[i]) {
+            for (int j = 2 * i; j <= n; j += i) composite[j] = true;
+        }
+        if (exlib::is_probable_prime(Int(i)) == composite[i] || (!composite[i] && exlib::next_prime(last) != i)) {
+            exlib::log_fatal("fatal prime {}", i);
+            return false;
+        }
+        if (!composite[i]) last = i;
+    }
+    // carmichael numbers, strong pseudoprimes to base 2 and a square of a prime
+    for (std::uint64_t c : {561ull, 1105ull, 2047ull, 3277ull, 4033ull, 4681ull, 8321ull, 3215031751ull, 3825123056546413051ull, 4295098369ull}) {
+        if (exlib::is_probable_prime(c) || exlib::is_probable_prime(Int(c), 3)) {
+            exlib::log_fatal("fatal pseudoprime {}", c);
+            return false;
+        }
+    }
+    using big = exlib::unints<1100, typename Int::word_type>;
+    const big one = 1;
+    const big p = exlib::next_prime(one << 1000);
+    return exlib::is_probable_prime((one << 127) - 1) && exlib::is_probable_prime((one << 521) - 1, 4) && !exlib::is_probable_prime((one << 128) + 1)
+        && !exlib::is_probable_prime((one << 1000) + 1) && exlib::next_prime(one << 64) == (one << 64) + 13 && p == (one << 1000) + 297
+        && exlib::next_prime(one << 1000, 4) == p && exlib::next_prime(18446744073709551533ull) == 18446744073709551557ull && [] {
+               try {
+                   exlib::next_prime(18446744073709551557ull);
+               } catch (const std::runtime_error&) {
+                   return true;
+               }
+               return false;
+           }();
+}
+
+// bigint against a wide integer on values of mixed lengths, small values stay inline
+template<class Word>
+bool check_bigint(int n) {
+    using big = exlib::basic_bigint<Word>;
+    using type = exlib::integer<4096, Word, void, true>;
+    for (int i = 0; i < n; ++i) {
+        type a = random_integer<type>(rand_engine() % 1500 + 1), b = random_integer<type>(rand_engine() % 1500 + 1);
+        if (i % 5 == 0) a = type(static_cast<int>(rand_engine() % 7) - 3);
+        if (i & 1) a = -a;
+        if (i & 2) b = -b;
+        const big x = a, y = b;
+        const std::size_t sh = rand_engine() % 200;
+        big z = x;
+        z += z;
+        bool ok = type(x + y) == a + b && type(x - y) == a - b && type(x * y) == a * b && type(z) == a + a
+               && (x < y) == (a < b) && (x == y) == (a == b) && x.bit_width() == a.abs().bit_width()
+               && type(x << sh) == (a << sh) && type(x >> sh) == (a >> sh) && static_cast<long long>(x) == static_cast<long long>(a)
+               && x.str() == a.str() && big(a.str()) == x && big(x.str(16), 16) == x;
+        if (b != 0) {
+            const auto [q, r] = x.divmod(y);
+            ok = ok && type(q) == a / b && type(r) == a % b;
+        }
+        if (!ok) {
+            exlib::log_fatal("fatal bigint {} {}", a.str(), b.str());
+            return false;
+        }
+    }
+    std::size_t allocs = 0;
+#ifdef __linux
+    const std::size_t before = zstl::_malloc_hook::allocations;
+#endif
+    big acc = 1;
+    for (int i = 0; i < 1000; ++i) {
+        acc = (acc * 3 + i) % 1000000007;
+    }
+#ifdef __linux
+    allocs = zstl::_malloc_hook::allocations - before;
+#endif
+    if (!(allocs == 0 && acc.limb_count() <= 128 / exlib::details::limb_bits<Word>)) {
+        exlib::log_fatal("fatal bigint inline storage, {} allocations", allocs);
+        return false;
+    }
+
+    // sums, products and shifts of 65 to 127-bit values whose results fit in 128 bits stay
+    // inline too, the second round is counted once the scratch stacks are warm
+    std::vector<type> as, bs;
+    std::vector<big> xs, ys;
+    std::vector<std::size_t> shifts;
+    for (int i = 0; i < 200; ++i) {
+        const std::size_t abits = 65 + rand_engine() % 63, bbits = 1 + rand_engine() % (128 - abits);
+        type a = random_integer<type>(abits) | (type(1) << (abits - 1)), b = random_integer<type>(bbits) | type(1);
+        if (i & 1) a = -a;
+        if (i & 2) b = -b;
+        as.push_back(a), bs.push_back(b), xs.emplace_back(a), ys.emplace_back(b), shifts.push_back(128 - abits);
+    }
+    bool fits = true;
+    for (int round = 0; round < 2; ++round) {
+#ifdef __linux
+        const std::size_t start = zstl::_malloc_hook::allocations;
+#endif
+        for (std::size_t k = 0; k < xs.size(); ++k) {
+            const big sum = xs[k] + ys[k], prod = xs[k] * ys[k];
+            big sh = xs[k];
+            sh <<= shifts[k];
+            fits = fits && type(sum) == as[k] + bs[k] && type(prod) == as[k] * bs[k] && type(sh) == (as[k] << shifts[k]);
+        }
+#ifdef __linux
+        allocs = zstl::_malloc_hook::allocations - start;
+#endif
+    }
+    bool base_thrown = false;
+    try {
+        (void)big(10).str(3);
+    } catch (const std::runtime_error&) {
+        base_thrown = true;
+    }
+    if (!(fits && allocs == 0 && base_thrown)) {
+        exlib::log_fatal("fatal bigint up to 128 bits, {} allocations", allocs);
+        return false;
+    }
+    return true;
+}
+
+// byte images in both orders and formats against bits read one at a time, the in place
+// view and the word at a time conversion to builtins
+template<class Int>
+bool check_bytes(int n) {
+    constexpr std::size_t N = Int::size();
+    using mag_type = exlib::integer<N, typename Int::word_type, void, false>;
+    for (int i = 0; i < n; ++i) {
+        Int x = random_integer<Int>(rand_engine() % N + 1);
+        if (i & 1) x = Int(0) - x;
+        const mag_type m = x.sign() ? mag_type(0) - mag_type(x) : mag_type(x);
+        bool ok = true;
+        for (auto fmt : {exlib::byte_format::twos_complement, exlib::byte_format::magnitude}) {
+            const bool twos = fmt == exlib::byte_format::twos_complement;
+            for (auto order : {std::endian::little, std::endian::big}) {
+                const std::size_t len = x.byte_width(fmt) + rand_engine() % 3;
+                std::vector<std::byte> out(len), ref(len);
+                x.to_bytes(out, order, fmt);
+                for (std::size_t k = 0; k < 8 * len; ++k) {
+                    const bool b = twos ? (k < N ? bool(x[k]) : bool(x.sign())) : k < N && bool(m[k]);
+                    ref[order == std::endian::big ? len - 1 - k / 8 : k / 8] |= std::byte(b << (k % 8));
+                }
+                ok = ok && out == ref && Int().from_bytes(out, order, fmt, x.sign()) == x;
+                if (x.byte_width(fmt) > 0) {
+                    out.resize(x.byte_width(fmt) - 1);
+                    try {
+                        x.to_bytes(out, order, fmt);
+                        ok = false;
+                    } catch (const std::runtime_error&) {}
+                }
+            }
+        }
+        if constexpr (exlib::details::is_limb_v<typename Int::word_type>) {
+            if constexpr (std::endian::native == std::endian::little) {
+                std::vector<std::byte> out(x.as_bytes().size());
+                x.to_bytes(out);
+                ok = ok && std::equal(out.begin(), out.end(), x.as_bytes().begin());
+            }
+        }
+        std::uint64_t low = 0;
+        for (std::size_t k = 0; k < 64; ++k) {
+            low |= std::uint64_t(k < N ? bool(x[k]) : bool(x.sign())) << k;
+        }
+        ok = ok && static_cast<std::uint64_t>(x) == low && static_cast<std::int16_t>(x) == static_cast<std::int16_t>(low);
+        if (!ok) {
+            exlib::log_fatal("fatal bytes of {}", x.str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// fixed width integers are usable in constant expressions, literals included
+using namespace exlib::literals;
+using cwide = exlib::integer<512, std::uint64_t, void, true>;
+
+constexpr bool constexpr_arith() {
+    cwide a("-123456789012345678901234567890123456789");
+    cwide b = a * a + 17;
+    auto [q, r] = b.divmod(a);
+    return q == a && r == 17 && ((a << 100) >> 100) == a && (~a) == -a - 1 && a.str() == "-123456789012345678901234567890123456789";
+}
+
+static_assert(constexpr_arith());
+
+constexpr bool constexpr_expr() {
+    const cwide a = 5, b = -7;
+    const cwide r = exlib::lazy(a) * b + 3 - exlib::lazy(b) * b;
+    return r == -81;
+}
+
+static_assert(constexpr_expr());
+static_assert(exlib::gcd(cwide(1071) << 200, cwide(-462) << 190) == cwide(21) << 191 && exlib::modinv(cwide(3), cwide(1000000007)) == 333333336);
+static_assert((cwide(-1) << 100).countr_zero() == 100 && cwide(-1).popcount() == 512 && cwide(5).bit_width() == 3 && cwide(1).countl_zero() == 511);
+static_assert(exlib::isqrt(cwide(1000000007) * 1000000007) == 1000000007 && exlib::iroot(cwide(-1000000000), 3) == -1000);
+static_assert(0xffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff_u128 == ~exlib::integer<128, unsigned int, void, false>(0));
+static_assert(-170141183460469231731687303715884105727_n128 - 1 == (exlib::integer<128, unsigned int, void, true>(1) << 127));
+static_assert(0b1010_n64 == 10 && 017_n64 == 15 && 1'000'000_n256 == 1000000 && (-5_n256).str() == "-5");
+static_assert((123456789012345678901234567890_n256 * 987654321098765432109876543210_n256).str() == "121932631137021795226185032733622923332237463801111263526900");
+static_assert(exlib::pow(3_u1024, 600) % 1000000007 == 569243565);
+static_assert([] {
+    std::array<std::byte, 70> b{};
+    cwide(-5).to_bytes(b, std::endian::big);
+    return b[69] == std::byte{0xfb} && b[0] == std::byte{0xff} && cwide().from_bytes(b, std::endian::big) == -5 && cwide(-5).byte_width() == 1;
+}());
+static_assert(exlib::unints<1024>((exlib::bigint(3) << 900) / exlib::bigint("-123456789012345678901234567890")) == 0 - (3_u1024 << 900) / 123456789012345678901234567890_u1024);
+
+// the same values computed at run time through the fast kernels
+bool check_constexpr() {
+    constexpr auto c = exlib::pow(3_u1024, 600);
+    exlib::unints<1024> r = 1;
+    for (int i = 0; i < 600; ++i) r *= 3;
+    if (!(r == c && constexpr_arith())) {
+        exlib::log_fatal("fatal constexpr {}", c.str());
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    exlib::set_log_level(exlib::log_level::info);
+
+    bool ok = check_native<std::uint8_t>(20000)
+           && check_native<std::uint16_t>(20000)
+           && check_native<std::uint32_t>(20000)
+           && check_native<std::uint64_t>(20000)
+           && check_odd_width<20, std::uint8_t>(20000)
+           && check_odd_width<20, std::uint32_t>(20000)
+           && check_odd_width<37, std::uint16_t>(20000)
+           && check_odd_width<37, std::uint64_t>(20000)
+           && check_odd_width<48, std::uint8_t>(20000)
+           && check_odd_width<48, std::uint64_t>(20000)
+           && check_odd_width<50, std::uint32_t>(20000)
+           && check_odd_width<63, std::uint16_t>(20000)
+           && check_odd_width<63, std::uint64_t>(20000)
+           && check_add_kernels(5000)
+           && check_mul_kernels(3000)
+           && check_divmod<256, std::uint32_t>(2000)
+           && check_divmod<1000, std::uint64_t>(500)
+           && check_divmod<4096, std::uint32_t>(100)
+           && check_divmod<70000, std::uint32_t>(1)
+           && check_divmod_api<256, std::uint32_t>(500)
+           && check_divmod_api<640, std::uint64_t>(200)
+           && check_mixed<std::uint8_t, std::uint32_t>(5000)
+           && check_mixed<std::uint64_t, std::uint16_t>(5000)
+           && check_barrett<std::uint32_t>(300)
+           && check_barrett<std::uint64_t>(300)
+           && check_toom<std::uint32_t>(300)
+           && check_toom<std::uint64_t>(300)
+           && check_ntt<std::uint32_t>(100)
+           && check_ntt<std::uint64_t>(100)
+           && check_montgomery<256, std::uint32_t>(300)
+           && check_montgomery<1024, std::uint64_t>(50)
+           && check_montgomery<2048, std::uint32_t>(10)
+           && check_modint<128, std::uint8_t>(300)
+           && check_modint<256, std::uint32_t>(300)
+           && check_modint<1024, std::uint64_t>(100)
+           && check_fma<256, 128, 128, std::uint32_t>(2000)
+           && check_fma<100, 70, 45, std::uint8_t>(2000)
+           && check_fma<4096, 3000, 2048, std::uint64_t>(200)
+           && check_str()
+           && check_str_dc<std::uint32_t>(50)
+           && check_str_dc<std::uint64_t>(50)
+           && check_rd_string<64, std::uint8_t>(2000)
+           && check_rd_string<1000, std::uint64_t>(300)
+           && check_rd_string<20000, std::uint32_t>(20)
+           && check_radix<std::uint8_t>(1000)
+           && check_radix<std::uint64_t>(1000)
+           && check_format()
+           && check_storage<256, std::uint8_t>(500)
+           && check_storage<1000, std::uint64_t>(200)
+           && check_allocators<256, std::uint32_t>(200)
+           && check_allocators<70000, std::uint64_t>(20)
+           && check_pool_teardown()
+           && check_expr<exlib::nints<256>>(1000)
+           && check_expr<exlib::unints<100, std::uint8_t>>(1000)
+           && check_expr<exlib::integer<2000, std::uint64_t, void, true>>(200)
+           && check_expr<exlib::integer<64, exlib::details::uint4_t, void, true>>(200)
+           && check_roots<64, std::uint32_t>(3000)
+           && check_roots<256, std::uint8_t>(500)
+           && check_roots<1000, std::uint64_t>(300)
+           && check_roots<4096, std::uint32_t>(30)
+           && check_gcd<64, std::uint64_t>(3000)
+           && check_gcd<256, std::uint8_t>(1000)
+           && check_gcd<256, std::uint32_t>(2000)
+           && check_gcd<1000, std::uint64_t>(500)
+           && check_gcd<4096, std::uint32_t>(100)
+           && check_bits<exlib::nints<100, std::uint8_t>>(2000)
+           && check_bits<exlib::unints<64, std::uint64_t>>(2000)
+           && check_bits<exlib::nints<256, std::uint32_t>>(1000)
+           && check_bits<exlib::unints<1000, std::uint64_t>>(300)
+           && check_bits<exlib::integer<70, exlib::details::uint4_t, void, true>>(300)
+           && check_primes<exlib::nints<64, std::uint8_t>>(20000)
+           && check_primes<exlib::unints<128, std::uint64_t>>(20000)
+           && check_primes<exlib::nints<256, std::uint32_t>>(5000)
+           && check_bigint<std::uint8_t>(500)
+           && check_bigint<std::uint32_t>(2000)
+           && check_bigint<std::uint64_t>(2000)
+           && check_bytes<exlib::nints<100, std::uint8_t>>(1000)
+           && check_bytes<exlib::unints<64, std::uint64_t>>(1000)
+           && check_bytes<exlib::nints<256, std::uint32_t>>(1000)
+           && check_bytes<exlib::nints<1000, std::uint64_t>>(300)
+           && check_bytes<exlib::integer<70, exlib::details::uint4_t, void, true>>(300)
+           && check_constexpr();
+
+    if (!ok) return -1;
+    exlib::log_info("all passed");
+    return 0;
+}